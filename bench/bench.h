@@ -0,0 +1,158 @@
+#pragma once
+// Minimal microbenchmark harness (no external dependency).
+// Each benchmark loops `while (state.KeepRunning())`; the harness grows the
+// iteration count until one run lasts at least min_time, then reports ns/op
+// and items/s. JSON output follows Google Benchmark's layout ("context" +
+// "benchmarks" with name / iterations / real_time / time_unit / items_per_second)
+// so its compare tooling can diff two runs.
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+class BenchState {
+public:
+    explicit BenchState(long iterations) : m_iterations(iterations), m_left(iterations) {}
+
+    bool KeepRunning() {
+        if (m_left == m_iterations && !m_started) Start();
+        if (m_left-- > 0) return true;
+        Stop();
+        return false;
+    }
+
+    // Excludes per-iteration setup from the measurement
+    void PauseTiming() { m_elapsed += Clock::now() - m_start; }
+    void ResumeTiming() { m_start = Clock::now(); }
+
+    void SetItemsProcessed(long items) { m_items = items; }
+    void SetLabel(const std::string& label) { m_label = label; }
+    void SkipWithError(const char* msg) { m_error = msg; m_left = 0; }
+
+    long iterations() const { return m_iterations; }
+    double Seconds() const { return std::chrono::duration<double>(m_elapsed).count(); }
+    long items() const { return m_items; }
+    const std::string& label() const { return m_label; }
+    const std::string& error() const { return m_error; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+    long m_iterations;
+    long m_left;
+    bool m_started = false;
+    long m_items = 0;
+    std::string m_label, m_error;
+    Clock::time_point m_start;
+    Clock::duration m_elapsed = Clock::duration::zero();
+
+    void Start() { m_started = true; m_start = Clock::now(); }
+    void Stop() { if (m_started) { m_elapsed += Clock::now() - m_start; m_started = false; } }
+};
+
+class BenchRunner {
+public:
+    typedef std::function<void(BenchState&)> Fn;
+
+    void Register(const char* name, Fn fn) { m_benches.push_back({ name, fn }); }
+
+    // argv: --filter=SUBSTR, --min_time=SECONDS, --json=PATH (other flags are left to the caller)
+    void ParseArgs(int argc, char** argv) {
+        for (int i = 1; i < argc; i++) {
+            if (!strncmp(argv[i], "--filter=", 9)) m_filter = argv[i] + 9;
+            else if (!strncmp(argv[i], "--min_time=", 11)) m_min_time = atof(argv[i] + 11);
+            else if (!strncmp(argv[i], "--json=", 7)) m_json_path = argv[i] + 7;
+        }
+    }
+
+    int RunAll() {
+        printf("%-44s %14s %12s %14s\n", "Benchmark", "ns/op", "iterations", "items/s");
+        for (const Bench& b : m_benches) {
+            if (!m_filter.empty() && b.name.find(m_filter) == std::string::npos) continue;
+            Result r = RunOne(b);
+            if (!r.error.empty()) printf("%-44s ERROR: %s\n", r.name.c_str(), r.error.c_str());
+            else printf("%-44s %14.1f %12ld %14.0f %s\n", r.name.c_str(), r.ns_per_op, r.iterations, r.items_per_second, r.label.c_str());
+            m_results.push_back(r);
+        }
+        return m_json_path.empty() ? 0 : WriteJson(m_json_path.c_str());
+    }
+
+private:
+    struct Bench { std::string name; Fn fn; };
+    struct Result {
+        std::string name, label, error;
+        long iterations = 0;
+        double ns_per_op = 0.0, items_per_second = 0.0;
+    };
+
+    std::vector<Bench> m_benches;
+    std::vector<Result> m_results;
+    std::string m_filter, m_json_path;
+    double m_min_time = 0.2;
+
+    Result RunOne(const Bench& b) {
+        Result r;
+        r.name = b.name;
+        for (long n = 1;; ) {
+            BenchState st(n);
+            b.fn(st);
+            r.error = st.error();
+            if (!r.error.empty()) return r;
+            double secs = st.Seconds();
+            if (secs >= m_min_time || n >= 1000000000L) {
+                r.iterations = n;
+                r.ns_per_op = secs * 1e9 / (double)n;
+                r.items_per_second = (st.items() > 0 && secs > 0.0) ? (double)st.items() / secs : 0.0;
+                r.label = st.label();
+                return r;
+            }
+            // Aim for min_time with 40% headroom, grow at most 10x per round
+            double scale = (secs > 0.0) ? (m_min_time * 1.4) / secs : 10.0;
+            long next = (long)((double)n * (scale > 10.0 ? 10.0 : scale));
+            n = (next > n) ? next : n + 1;
+        }
+    }
+
+    static void JsonString(FILE* f, const std::string& s) {
+        fputc('"', f);
+        for (char c : s) {
+            if (c == '"' || c == '\\') fputc('\\', f);
+            if ((unsigned char)c >= 0x20) fputc(c, f);
+        }
+        fputc('"', f);
+    }
+
+    int WriteJson(const char* path) {
+        FILE* f = fopen(path, "w");
+        if (!f) { fprintf(stderr, "cannot write %s\n", path); return 1; }
+        char date[32];
+        time_t t = time(nullptr);
+        strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&t));
+        fprintf(f, "{\n  \"context\": {\n    \"date\": \"%s\",\n    \"library_build_type\": \"%s\",\n    \"executable\": \"soundfirst_bench\"\n  },\n",
+#ifdef NDEBUG
+                date, "release");
+#else
+                date, "debug");
+#endif
+        fprintf(f, "  \"benchmarks\": [\n");
+        for (size_t i = 0; i < m_results.size(); i++) {
+            const Result& r = m_results[i];
+            fprintf(f, "    {\n      \"name\": "); JsonString(f, r.name);
+            fprintf(f, ",\n      \"run_name\": "); JsonString(f, r.name);
+            fprintf(f, ",\n      \"run_type\": \"iteration\"");
+            if (!r.error.empty()) {
+                fprintf(f, ",\n      \"error_occurred\": true,\n      \"error_message\": "); JsonString(f, r.error);
+            }
+            fprintf(f, ",\n      \"iterations\": %ld,\n      \"real_time\": %.3f,\n      \"cpu_time\": %.3f,\n      \"time_unit\": \"ns\"",
+                    r.iterations, r.ns_per_op, r.ns_per_op);
+            if (r.items_per_second > 0.0) fprintf(f, ",\n      \"items_per_second\": %.3f", r.items_per_second);
+            if (!r.label.empty()) { fprintf(f, ",\n      \"label\": "); JsonString(f, r.label); }
+            fprintf(f, "\n    }%s\n", (i + 1 < m_results.size()) ? "," : "");
+        }
+        fprintf(f, "  ]\n}\n");
+        fclose(f);
+        return 0;
+    }
+};
@@ -0,0 +1,39 @@
+#pragma once
+// Minimal SWELL stand-in for the headless host (bench/fake_host).
+// reaper_plugin.h includes "../WDL/swell/swell.h" on non-Windows builds; only
+// the types its declarations need are provided here, no window system.
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+typedef struct HWND__* HWND;
+typedef struct HMENU__* HMENU;
+typedef struct HDC__* HDC;
+typedef struct HFONT__* HFONT;
+typedef struct HICON__* HICON;
+typedef struct HGDIOBJ__* HGDIOBJ;
+typedef void* HINSTANCE;
+typedef void* HANDLE;
+
+typedef unsigned int DWORD;
+typedef unsigned int UINT;
+typedef int BOOL;
+typedef unsigned char BYTE;
+typedef unsigned short WORD;
+typedef intptr_t INT_PTR;
+typedef uintptr_t UINT_PTR;
+typedef intptr_t LPARAM;
+typedef uintptr_t WPARAM;
+typedef intptr_t LRESULT;
+
+#ifndef TRUE
+#define TRUE 1
+#define FALSE 0
+#endif
+#define INVALID_HANDLE_VALUE ((HANDLE)(intptr_t)-1)
+
+typedef struct { int left, top, right, bottom; } RECT;
+typedef struct { int x, y; } POINT;
+typedef struct { HWND hwnd; UINT message; WPARAM wParam; LPARAM lParam; DWORD time; POINT pt; } MSG;
+typedef struct { BYTE fVirt; WORD key; WORD cmd; } ACCEL;
+typedef struct { unsigned int Data1; unsigned short Data2, Data3; unsigned char Data4[8]; } GUID;
@@ -0,0 +1,73 @@
+// Drives CSurf_SoundFirst on the fake host: builds a session, loads the plugin
+// through its entry point, injects a scripted stream of HID reports and runs
+// Run() at 30 Hz of virtual time. Deterministic; useful under perf/valgrind.
+//
+//   g++ -O2 -g -std=c++17 -Ibench/fake_host/include -Iinclude -Isrc src/main.cpp src/csurf_soundfirst.cpp bench/fake_host/fake_reaper.cpp bench/fake_host/drive_surface.cpp -o drive_surface -lpthread
+//   ./drive_surface [seconds] [--api-trace]
+#include "fake_reaper.h"
+#include "csurf_soundfirst.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using fake_reaper::FakeHost;
+using fake_reaper::Report;
+
+int main(int argc, char** argv) {
+    double seconds = (argc > 1) ? atof(argv[1]) : 10.0;
+    bool api_trace = (argc > 2) && !strcmp(argv[2], "--api-trace");
+
+    FakeHost& host = FakeHost::Instance();
+    host.Reset();
+    for (int i = 0; i < 64; i++) {
+        char name[32]; snprintf(name, sizeof(name), "Track %d", i + 1);
+        host.AddTrack(name);
+        host.AddFX(i, "VST3: Pro-Q 3 (FabFilter)", 200);
+        host.AddFX(i, "VST3: CLA-76 (Waves)", 16);
+    }
+    host.SelectOnlyTrack(0);
+
+    CSurf_SoundFirst* surface = static_cast<CSurf_SoundFirst*>(host.LoadPlugin());
+    if (!surface) { fprintf(stderr, "plugin did not load\n"); return 1; }
+    printf("loaded: %d API functions not provided by the fake host\n", host.missing_functions);
+    host.ClearOutput();
+    if (api_trace) ApiTracer::Enable(true);
+
+    // Every tick: 4 reports (the keyboard reports ~120 Hz), all 8 knobs turning,
+    // knob 1 touched for the first half of every second; PLUGIN mode after 50%.
+    Report r;
+    int knob[8] = { 0 };
+    const double tick = 1.0 / 30.0;
+    long ticks = 0, reports = 0;
+    for (double t = 0.0; t < seconds; t += tick, ticks++) {
+        if (t >= seconds / 2 && t < seconds / 2 + tick) {
+            Report press = r; press.data[3] |= 0x02; // PLUGIN
+            surface->InjectHidReport(press.data, 64);
+            surface->InjectHidReport(r.data, 64);
+        }
+        for (int sub = 0; sub < 4; sub++, reports++) {
+            for (int k = 0; k < 8; k++) {
+                knob[k] = (knob[k] + 1 + k) & 0x3FF;
+                r.Knob(k, knob[k]);
+            }
+            r.Touch(0, (ticks % 30) < 15);
+            surface->InjectHidReport(r.data, 64);
+        }
+        host.Advance(tick);
+        surface->Run();
+    }
+
+    long total_commands = 0;
+    for (auto& c : host.commands) total_commands += c.second;
+    printf("%ld ticks, %ld reports\n", ticks, reports);
+    printf("API calls: %ld (%.1f per tick)\n", host.api_calls, (double)host.api_calls / ticks);
+    printf("commands: %ld, undo points: %ld, MIDI out: %ld messages / %ld bytes, utterances: %zu\n",
+           total_commands, host.undo_points, host.midi_messages, host.midi_bytes, host.speech.size());
+    printf("track 1: vol %.3f pan %.3f\n", host.TrackAt(0).vol, host.TrackAt(0).pan);
+
+    if (api_trace) printf("\n%s", ApiTracer::Dump().c_str());
+
+    host.UnloadPlugin();
+    return 0;
+}
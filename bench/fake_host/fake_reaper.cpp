@@ -0,0 +1,591 @@
+// Fake REAPER host: API implementations and plugin loading. See fake_reaper.h.
+#include "fake_reaper.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <string>
+#include <utility>
+
+extern "C" int ReaperPluginEntry(REAPER_PLUGIN_HINSTANCE hInstance, reaper_plugin_info_t* rec);
+
+namespace fake_reaper {
+
+static FakeHost& H() { return FakeHost::Instance(); }
+
+static Track* AsTrack(MediaTrack* tr) { return reinterpret_cast<Track*>(tr); }
+static MediaTrack* AsMediaTrack(Track* t) { return reinterpret_cast<MediaTrack*>(t); }
+static Item* AsItem(MediaItem* it) { return reinterpret_cast<Item*>(it); }
+static Item* AsItem(MediaItem_Take* tk) { return reinterpret_cast<Item*>(tk); } // A take is its item here
+
+static void CopyOut(char* buf, int sz, const std::string& s) {
+    if (!buf || sz <= 0) return;
+    snprintf(buf, (size_t)sz, "%s", s.c_str());
+}
+
+static FX* FindFX(MediaTrack* tr, int fx) {
+    Track* t = AsTrack(tr);
+    if (!t || fx < 0 || fx >= (int)t->fx.size()) return nullptr;
+    return &t->fx[fx];
+}
+
+static Param* FindParam(MediaTrack* tr, int fx, int param) {
+    FX* f = FindFX(tr, fx);
+    if (!f || param < 0 || param >= (int)f->params.size()) return nullptr;
+    return &f->params[param];
+}
+
+// --- Fake API ---
+// Signatures match reaper_plugin_functions.h; every entry bumps api_calls.
+
+static double Api_time_precise() { H().api_calls++; return H().now; }
+
+static int Api_GetNumMIDIInputs() { H().api_calls++; return 1; }
+static int Api_GetNumMIDIOutputs() { H().api_calls++; return 1; }
+static bool Api_GetMIDIInputName(int dev, char* out, int sz) { H().api_calls++; CopyOut(out, sz, "Komplete Kontrol DAW - 1"); return dev == 0; }
+static bool Api_GetMIDIOutputName(int dev, char* out, int sz) { H().api_calls++; CopyOut(out, sz, "Komplete Kontrol DAW - 1"); return dev == 0; }
+
+// MIDI output sink: counts everything the surface sends (LCD SysEx, CCs)
+class SinkOutput : public midi_Output {
+public:
+    void SendMsg(MIDI_event_t* msg, int) override {
+        FakeHost& h = H();
+        h.midi_messages++;
+        h.midi_bytes += msg->size;
+        if (msg->size > 3) h.last_sysex.assign(msg->midi_message, msg->midi_message + msg->size);
+    }
+    void Send(unsigned char, unsigned char, unsigned char, int) override { H().midi_messages++; H().midi_bytes += 3; }
+};
+static midi_Output* Api_CreateMIDIOutput(int, bool, int*) { H().api_calls++; return new SinkOutput(); }
+
+static const char* Api_GetResourcePath() { H().api_calls++; return H().resource_path.c_str(); }
+
+static MediaTrack* Api_GetTrack(ReaProject*, int idx) {
+    H().api_calls++;
+    return (idx >= 0 && idx < H().NumTracks()) ? AsMediaTrack(&H().TrackAt(idx)) : nullptr;
+}
+
+static int Api_CountSelectedTracks(ReaProject*) {
+    H().api_calls++;
+    int n = 0;
+    for (auto& t : H().tracks) n += t->selected ? 1 : 0;
+    return n;
+}
+
+static MediaTrack* Api_GetSelectedTrack(ReaProject*, int sel) {
+    H().api_calls++;
+    for (auto& t : H().tracks) {
+        if (t->selected && sel-- == 0) return AsMediaTrack(t.get());
+    }
+    return nullptr;
+}
+
+static int Api_CountTracks(ReaProject*) { H().api_calls++; return H().NumTracks(); }
+
+static void Api_SetOnlyTrackSelected(MediaTrack* tr) {
+    H().api_calls++;
+    H().SelectOnlyTrack(H().IndexOf(AsTrack(tr)));
+}
+
+static MediaTrack* Api_GetLastTouchedTrack() {
+    H().api_calls++;
+    int i = H().last_touched_track;
+    return (i >= 0 && i < H().NumTracks()) ? AsMediaTrack(&H().TrackAt(i)) : nullptr;
+}
+
+static bool Api_GetLastTouchedFX(int* track, int* fx, int* param) {
+    H().api_calls++;
+    if (H().last_touched_track < 0) return false;
+    if (track) *track = H().last_touched_track + 1; // 1-based, 0 = master
+    if (fx) *fx = H().last_touched_fx;
+    if (param) *param = H().last_touched_param;
+    return true;
+}
+
+static double Api_GetMediaTrackInfo_Value(MediaTrack* tr, const char* parm) {
+    H().api_calls++;
+    Track* t = AsTrack(tr);
+    if (!t) return 0.0;
+    if (!strcmp(parm, "D_VOL")) return t->vol;
+    if (!strcmp(parm, "D_PAN")) return t->pan;
+    if (!strcmp(parm, "I_SOLO")) return t->solo;
+    if (!strcmp(parm, "B_MUTE")) return t->mute;
+    if (!strcmp(parm, "I_SELECTED")) return t->selected ? 1.0 : 0.0;
+    if (!strcmp(parm, "IP_TRACKNUMBER")) return H().IndexOf(t) + 1;
+    return 0.0;
+}
+
+static bool Api_SetMediaTrackInfo_Value(MediaTrack* tr, const char* parm, double v) {
+    H().api_calls++;
+    Track* t = AsTrack(tr);
+    if (!t) return false;
+    if (!strcmp(parm, "D_VOL")) t->vol = (v < 0.0) ? 0.0 : v;
+    else if (!strcmp(parm, "D_PAN")) t->pan = (v < -1.0) ? -1.0 : (v > 1.0 ? 1.0 : v);
+    else if (!strcmp(parm, "I_SOLO")) t->solo = (int)v;
+    else if (!strcmp(parm, "B_MUTE")) t->mute = (int)v;
+    else if (!strcmp(parm, "I_SELECTED")) t->selected = (v != 0.0);
+    else return false;
+    return true;
+}
+
+static void* Api_GetSetMediaTrackInfo(MediaTrack* tr, const char* parm, void* set) {
+    H().api_calls++;
+    Track* t = AsTrack(tr);
+    if (!t) return nullptr;
+    if (!strcmp(parm, "I_SOLO")) { if (set) t->solo = *(int*)set; return &t->solo; }
+    if (!strcmp(parm, "B_MUTE")) { if (set) t->mute = *(int*)set; return &t->mute; }
+    if (!strcmp(parm, "D_VOL")) { if (set) t->vol = *(double*)set; return &t->vol; }
+    if (!strcmp(parm, "D_PAN")) { if (set) t->pan = *(double*)set; return &t->pan; }
+    if (!strcmp(parm, "P_NAME")) { if (set) t->name = (const char*)set; return (void*)t->name.c_str(); }
+    return nullptr;
+}
+
+static double Api_Track_GetPeakInfo(MediaTrack* tr, int ch) {
+    H().api_calls++;
+    Track* t = AsTrack(tr);
+    return (t && ch >= 0 && ch < 2) ? t->peak[ch] : 0.0;
+}
+
+static int Api_TrackFX_GetCount(MediaTrack* tr) { H().api_calls++; Track* t = AsTrack(tr); return t ? (int)t->fx.size() : 0; }
+
+static bool Api_TrackFX_GetFXName(MediaTrack* tr, int fx, char* out, int sz) {
+    H().api_calls++;
+    FX* f = FindFX(tr, fx);
+    CopyOut(out, sz, f ? f->name : std::string());
+    return f != nullptr;
+}
+
+static int Api_TrackFX_GetNumParams(MediaTrack* tr, int fx) { H().api_calls++; FX* f = FindFX(tr, fx); return f ? (int)f->params.size() : 0; }
+
+static double Api_TrackFX_GetParam(MediaTrack* tr, int fx, int param, double* mn, double* mx) {
+    H().api_calls++;
+    if (mn) *mn = 0.0;
+    if (mx) *mx = 1.0;
+    Param* p = FindParam(tr, fx, param);
+    return p ? p->value : 0.0;
+}
+
+static double Api_TrackFX_GetParamNormalized(MediaTrack* tr, int fx, int param) {
+    H().api_calls++;
+    Param* p = FindParam(tr, fx, param);
+    return p ? p->value : 0.0;
+}
+
+static bool Api_TrackFX_SetParam(MediaTrack* tr, int fx, int param, double v) {
+    H().api_calls++;
+    Param* p = FindParam(tr, fx, param);
+    if (!p) return false;
+    p->value = (v < 0.0) ? 0.0 : (v > 1.0 ? 1.0 : v);
+    return true;
+}
+
+static bool Api_TrackFX_GetParamName(MediaTrack* tr, int fx, int param, char* out, int sz) {
+    H().api_calls++;
+    Param* p = FindParam(tr, fx, param);
+    CopyOut(out, sz, p ? p->name : std::string());
+    return p != nullptr;
+}
+
+static bool Api_TrackFX_GetFormattedParamValue(MediaTrack* tr, int fx, int param, char* out, int sz) {
+    H().api_calls++;
+    Param* p = FindParam(tr, fx, param);
+    if (!p) { CopyOut(out, sz, ""); return false; }
+    char buf[32]; snprintf(buf, sizeof(buf), "%.1f%%", p->value * 100.0);
+    CopyOut(out, sz, buf);
+    return true;
+}
+
+static bool Api_TrackFX_GetNamedConfigParm(MediaTrack* tr, int fx, const char* parm, char* out, int sz) {
+    H().api_calls++;
+    FX* f = FindFX(tr, fx);
+    if (!f || strcmp(parm, "GainReduction_dB") != 0 || f->gain_reduction_db == 0.0) return false;
+    char buf[32]; snprintf(buf, sizeof(buf), "%.2f", f->gain_reduction_db);
+    CopyOut(out, sz, buf);
+    return true;
+}
+
+static bool Api_TrackFX_GetEnabled(MediaTrack* tr, int fx) { H().api_calls++; FX* f = FindFX(tr, fx); return f && f->enabled; }
+static void Api_TrackFX_SetEnabled(MediaTrack* tr, int fx, bool en) { H().api_calls++; if (FX* f = FindFX(tr, fx)) f->enabled = en; }
+static void Api_TrackFX_Show(MediaTrack* tr, int fx, int flag) { H().api_calls++; if (FX* f = FindFX(tr, fx)) f->shown = (flag != 0 && flag != 2); }
+
+static int Api_CountSelectedMediaItems(ReaProject*) {
+    H().api_calls++;
+    int n = 0;
+    for (auto& it : H().items) n += it->selected ? 1 : 0;
+    return n;
+}
+
+static MediaItem* Api_GetSelectedMediaItem(ReaProject*, int sel) {
+    H().api_calls++;
+    for (auto& it : H().items) {
+        if (it->selected && sel-- == 0) return reinterpret_cast<MediaItem*>(it.get());
+    }
+    return nullptr;
+}
+
+static MediaItem_Take* Api_GetActiveTake(MediaItem* item) { H().api_calls++; return reinterpret_cast<MediaItem_Take*>(item); }
+
+static double Api_GetMediaItemInfo_Value(MediaItem* item, const char* parm) {
+    H().api_calls++;
+    Item* it = AsItem(item);
+    if (!it) return 0.0;
+    if (!strcmp(parm, "D_POSITION")) return it->position;
+    if (!strcmp(parm, "D_LENGTH")) return it->length;
+    if (!strcmp(parm, "D_FADEINLEN")) return it->fade_in;
+    if (!strcmp(parm, "D_FADEOUTLEN")) return it->fade_out;
+    if (!strcmp(parm, "B_UISEL")) return it->selected ? 1.0 : 0.0;
+    return 0.0;
+}
+
+static bool Api_SetMediaItemInfo_Value(MediaItem* item, const char* parm, double v) {
+    H().api_calls++;
+    Item* it = AsItem(item);
+    if (!it) return false;
+    if (!strcmp(parm, "D_POSITION")) it->position = v;
+    else if (!strcmp(parm, "D_LENGTH")) it->length = v;
+    else if (!strcmp(parm, "D_FADEINLEN")) it->fade_in = v;
+    else if (!strcmp(parm, "D_FADEOUTLEN")) it->fade_out = v;
+    else if (!strcmp(parm, "B_UISEL")) it->selected = (v != 0.0);
+    else return false;
+    return true;
+}
+
+static double Api_GetMediaItemTakeInfo_Value(MediaItem_Take* take, const char* parm) {
+    H().api_calls++;
+    Item* it = AsItem(take);
+    if (!it) return 0.0;
+    if (!strcmp(parm, "D_VOL")) return it->take_vol;
+    if (!strcmp(parm, "D_STARTOFFS")) return it->take_offset;
+    if (!strcmp(parm, "D_PLAYRATE")) return it->take_rate;
+    return 0.0;
+}
+
+static bool Api_SetMediaItemTakeInfo_Value(MediaItem_Take* take, const char* parm, double v) {
+    H().api_calls++;
+    Item* it = AsItem(take);
+    if (!it) return false;
+    if (!strcmp(parm, "D_VOL")) it->take_vol = v;
+    else if (!strcmp(parm, "D_STARTOFFS")) it->take_offset = v;
+    else if (!strcmp(parm, "D_PLAYRATE")) it->take_rate = v;
+    else return false;
+    return true;
+}
+
+static bool Api_ValidatePtr2(ReaProject*, void* ptr, const char* type) {
+    H().api_calls++;
+    if (!ptr) return false;
+    if (!strcmp(type, "MediaTrack*")) {
+        for (auto& t : H().tracks) if (t.get() == ptr) return true;
+    } else if (!strcmp(type, "MediaItem*")) {
+        for (auto& it : H().items) if (it.get() == ptr) return true;
+    }
+    return false;
+}
+
+// Action dispatcher: every command is counted; track navigation, mute and
+// solo are simulated because the surface reads their effect right back.
+static void Api_Main_OnCommand(int cmd, int) {
+    FakeHost& h = H();
+    h.api_calls++;
+    h.commands[cmd]++;
+    int sel = -1;
+    for (int i = 0; i < h.NumTracks(); i++) if (h.TrackAt(i).selected) { sel = i; break; }
+    switch (cmd) {
+        case 40285: if (h.NumTracks()) h.SelectOnlyTrack(sel < 0 ? 0 : (sel + 1) % h.NumTracks()); break; // Next track
+        case 40286: if (h.NumTracks()) h.SelectOnlyTrack(sel <= 0 ? h.NumTracks() - 1 : sel - 1); break; // Prev track
+        case 6: for (auto& t : h.tracks) if (t->selected) t->mute = !t->mute; break;
+        case 7: for (auto& t : h.tracks) if (t->selected) t->solo = t->solo ? 0 : 1; break;
+        case 40340: for (auto& t : h.tracks) t->solo = 0; break;
+        default: break;
+    }
+}
+
+static int Api_NamedCommandLookup(const char* name) {
+    H().api_calls++;
+    if (!name || !name[0]) return 0;
+    unsigned int hash = 2166136261u; // Stable fake ID per name (FNV-1a), in the custom-action range
+    for (const char* p = name; *p; p++) hash = (hash ^ (unsigned char)*p) * 16777619u;
+    return 50000 + (int)(hash % 10000);
+}
+
+static int Api_GetToggleCommandState(int) { H().api_calls++; return 0; }
+
+static HWND Api_MIDIEditor_GetActive() { H().api_calls++; return H().midi_editor_open ? reinterpret_cast<HWND>(&H()) : nullptr; }
+static bool Api_MIDIEditor_OnCommand(HWND, int cmd) { H().api_calls++; H().commands[cmd]++; return true; }
+
+// MIDI: the editor's take is FakeHost::midi_notes, 960 PPQ per quarter note from QN 0
+static const double kPPQ = 960.0;
+static std::vector<Note>* AsNotes(MediaItem_Take* take) { return (take == reinterpret_cast<MediaItem_Take*>(&H().midi_notes)) ? &H().midi_notes : nullptr; }
+
+static MediaItem_Take* Api_MIDIEditor_GetTake(HWND ed) {
+    H().api_calls++;
+    return (ed && H().midi_editor_open) ? reinterpret_cast<MediaItem_Take*>(&H().midi_notes) : nullptr;
+}
+static double Api_MIDI_GetGrid(MediaItem_Take*, double* swing, double* note_len) {
+    H().api_calls++;
+    if (swing) *swing = 0.0;
+    if (note_len) *note_len = 0.0;
+    return H().midi_grid_qn;
+}
+static double Api_MIDI_GetProjQNFromPPQPos(MediaItem_Take*, double ppq) { H().api_calls++; return ppq / kPPQ; }
+static double Api_MIDI_GetPPQPosFromProjQN(MediaItem_Take*, double qn) { H().api_calls++; return qn * kPPQ; }
+
+static int Api_MIDI_EnumSelNotes(MediaItem_Take* take, int idx) {
+    H().api_calls++;
+    std::vector<Note>* notes = AsNotes(take);
+    if (!notes) return -1;
+    for (int i = (idx < 0 ? 0 : idx + 1); i < (int)notes->size(); i++) if ((*notes)[i].selected) return i;
+    return -1;
+}
+
+static bool Api_MIDI_GetNote(MediaItem_Take* take, int idx, bool* sel, bool* muted, double* start, double* end, int* chan, int* pitch, int* vel) {
+    H().api_calls++;
+    std::vector<Note>* notes = AsNotes(take);
+    if (!notes || idx < 0 || idx >= (int)notes->size()) return false;
+    const Note& n = (*notes)[idx];
+    if (sel) *sel = n.selected;
+    if (muted) *muted = n.muted;
+    if (start) *start = n.start;
+    if (end) *end = n.end;
+    if (chan) *chan = n.chan;
+    if (pitch) *pitch = n.pitch;
+    if (vel) *vel = n.vel;
+    return true;
+}
+
+static void SortNotes(std::vector<Note>& notes) {
+    std::stable_sort(notes.begin(), notes.end(), [](const Note& a, const Note& b) { return a.start < b.start; });
+    H().midi_sorts++;
+}
+
+static bool Api_MIDI_SetNote(MediaItem_Take* take, int idx, const bool* sel, const bool* muted, const double* start, const double* end,
+                             const int* chan, const int* pitch, const int* vel, const bool* no_sort) {
+    H().api_calls++;
+    std::vector<Note>* notes = AsNotes(take);
+    if (!notes || idx < 0 || idx >= (int)notes->size()) return false;
+    Note& n = (*notes)[idx];
+    if (sel) n.selected = *sel;
+    if (muted) n.muted = *muted;
+    if (start) n.start = *start;
+    if (end) n.end = *end;
+    if (chan) n.chan = *chan;
+    if (pitch) n.pitch = *pitch;
+    if (vel) n.vel = *vel;
+    if (!no_sort || !*no_sort) SortNotes(*notes);
+    return true;
+}
+
+static void Api_MIDI_Sort(MediaItem_Take* take) { H().api_calls++; if (std::vector<Note>* notes = AsNotes(take)) SortNotes(*notes); }
+
+static void Api_PreventUIRefresh(int n) { H().api_calls++; H().ui_refresh_prevented += n; }
+static void Api_UpdateTimeline() { H().api_calls++; }
+
+static double Api_GetCursorPosition() { H().api_calls++; return H().edit_cursor; }
+static void Api_SetEditCurPos(double time, bool, bool) { H().api_calls++; H().edit_cursor = time; }
+
+static void Api_GetSet_LoopTimeRange(bool set, bool, double* start, double* end, bool) {
+    H().api_calls++;
+    if (set) { H().loop_start = *start; H().loop_end = *end; }
+    else { *start = H().loop_start; *end = H().loop_end; }
+}
+
+static double Api_TimeMap2_timeToBeats(ReaProject*, double t, int* measures, int* cml, double* full_beats, int* cdenom) {
+    H().api_calls++;
+    double beats = t * H().tempo_bpm / 60.0;
+    int bar = (int)std::floor(beats / H().beats_per_bar + 1e-9);
+    if (measures) *measures = bar;
+    if (cml) *cml = H().beats_per_bar;
+    if (full_beats) *full_beats = beats;
+    if (cdenom) *cdenom = 4;
+    return beats - bar * H().beats_per_bar;
+}
+
+static double Api_TimeMap2_beatsToTime(ReaProject*, double beats, const int* measures) {
+    H().api_calls++;
+    if (measures) beats += *measures * H().beats_per_bar;
+    return beats * 60.0 / H().tempo_bpm;
+}
+
+static void Api_format_timestr_pos(double t, char* buf, int sz, int) {
+    H().api_calls++;
+    double beats = t * H().tempo_bpm / 60.0;
+    int bar = (int)std::floor(beats / H().beats_per_bar + 1e-9);
+    snprintf(buf, sz, "%d.%.2f", bar + 1, beats - bar * H().beats_per_bar + 1.0);
+}
+static void Api_Undo_BeginBlock2(ReaProject*) { H().api_calls++; H().undo_blocks_open++; }
+static void Api_Undo_EndBlock2(ReaProject*, const char*, int) {
+    H().api_calls++;
+    if (H().undo_blocks_open > 0) H().undo_blocks_open--;
+    H().undo_points++;
+}
+static void Api_Undo_OnStateChangeEx2(ReaProject*, const char*, int, int) { H().api_calls++; H().undo_points++; }
+
+static void Api_mkvolstr(char* str, double vol) {
+    H().api_calls++;
+    if (vol <= 0.0000000298023223876953125) snprintf(str, 64, "-inf");
+    else snprintf(str, 64, "%+.2f", 20.0 * log10(vol));
+}
+
+static void Api_mkpanstr(char* str, double pan) {
+    H().api_calls++;
+    int p = (int)floor(fabs(pan) * 100.0 + 0.5);
+    if (p == 0) snprintf(str, 64, "center");
+    else snprintf(str, 64, "%d%%%c", p, pan < 0.0 ? 'L' : 'R');
+}
+
+static void Api_osara_outputMessage(const char* msg) { H().speech.push_back(msg ? msg : ""); }
+
+// Functions the fake does not implement resolve to a trap that names them
+// and aborts, so REAPERAPI_LoadAPI() succeeds and gaps show up when hit.
+static const int kMaxTraps = 1024;
+static const char* g_trap_names[kMaxTraps];
+static int g_trap_count = 0;
+
+template <int N> static void Trap() {
+    fprintf(stderr, "fake_reaper: %s is not implemented by the fake host\n", g_trap_names[N]);
+    abort();
+}
+
+template <int... N> static void* TrapAt(int i, std::integer_sequence<int, N...>) {
+    static void* const table[] = { (void*)&Trap<N>... };
+    return table[i];
+}
+
+static void* MakeTrap(const char* name) {
+    if (g_trap_count >= kMaxTraps) return nullptr;
+    g_trap_names[g_trap_count] = name; // Names come from static tables in the plugin
+    return TrapAt(g_trap_count++, std::make_integer_sequence<int, kMaxTraps>());
+}
+
+// --- FakeHost ---
+
+FakeHost& FakeHost::Instance() {
+    static FakeHost host;
+    return host;
+}
+
+void FakeHost::Reset() {
+    tracks.clear();
+    items.clear();
+    now = 0.0;
+    midi_editor_open = false;
+    midi_notes.clear();
+    midi_grid_qn = 0.25;
+    midi_sorts = 0;
+    tempo_bpm = 120.0;
+    beats_per_bar = 4;
+    edit_cursor = loop_start = loop_end = 0.0;
+    last_touched_track = last_touched_fx = last_touched_param = -1;
+    ui_refresh_prevented = 0;
+    undo_blocks_open = 0;
+    undo_points = 0;
+    ClearOutput();
+}
+
+void FakeHost::ClearOutput() {
+    commands.clear();
+    api_calls = 0;
+    midi_messages = 0;
+    midi_bytes = 0;
+    last_sysex.clear();
+    speech.clear();
+}
+
+Track& FakeHost::AddTrack(const char* name) {
+    tracks.emplace_back(new Track());
+    tracks.back()->name = name ? name : "";
+    return *tracks.back();
+}
+
+FX& FakeHost::AddFX(int track, const char* name, int num_params) {
+    Track& t = TrackAt(track);
+    t.fx.emplace_back();
+    FX& f = t.fx.back();
+    f.name = name;
+    f.params.resize(num_params);
+    for (int i = 0; i < num_params; i++) {
+        char pn[32]; snprintf(pn, sizeof(pn), "Param %d", i + 1);
+        f.params[i].name = pn;
+        f.params[i].value = 0.5;
+    }
+    return f;
+}
+
+Item& FakeHost::AddItem(int track, double position, double length) {
+    items.emplace_back(new Item());
+    Item& it = *items.back();
+    it.track = tracks[track].get();
+    it.position = position;
+    it.length = length;
+    return it;
+}
+
+void FakeHost::SelectOnlyTrack(int track) {
+    for (int i = 0; i < NumTracks(); i++) tracks[i]->selected = (i == track);
+}
+
+int FakeHost::IndexOf(const Track* t) const {
+    for (int i = 0; i < (int)tracks.size(); i++) if (tracks[i].get() == t) return i;
+    return -1;
+}
+
+void* FakeHost::GetFunc(const char* name) {
+    static const struct { const char* name; void* fn; } kApi[] = {
+#define FAKE_API(n) { #n, (void*)&Api_##n }
+        FAKE_API(time_precise),
+        FAKE_API(GetNumMIDIInputs), FAKE_API(GetNumMIDIOutputs), FAKE_API(GetMIDIInputName), FAKE_API(GetMIDIOutputName),
+        FAKE_API(CreateMIDIOutput), FAKE_API(GetResourcePath),
+        FAKE_API(CountTracks), FAKE_API(GetTrack), FAKE_API(CountSelectedTracks), FAKE_API(GetSelectedTrack),
+        FAKE_API(SetOnlyTrackSelected), FAKE_API(GetLastTouchedTrack),
+        FAKE_API(GetLastTouchedFX), FAKE_API(GetMediaTrackInfo_Value), FAKE_API(SetMediaTrackInfo_Value),
+        FAKE_API(GetSetMediaTrackInfo), FAKE_API(Track_GetPeakInfo),
+        FAKE_API(TrackFX_GetCount), FAKE_API(TrackFX_GetFXName), FAKE_API(TrackFX_GetNumParams), FAKE_API(TrackFX_GetParam),
+        FAKE_API(TrackFX_GetParamNormalized), FAKE_API(TrackFX_SetParam), FAKE_API(TrackFX_GetParamName),
+        FAKE_API(TrackFX_GetFormattedParamValue), FAKE_API(TrackFX_GetNamedConfigParm), FAKE_API(TrackFX_GetEnabled),
+        FAKE_API(TrackFX_SetEnabled), FAKE_API(TrackFX_Show),
+        FAKE_API(CountSelectedMediaItems), FAKE_API(GetSelectedMediaItem), FAKE_API(GetActiveTake),
+        FAKE_API(GetMediaItemInfo_Value), FAKE_API(SetMediaItemInfo_Value),
+        FAKE_API(GetMediaItemTakeInfo_Value), FAKE_API(SetMediaItemTakeInfo_Value), FAKE_API(ValidatePtr2),
+        FAKE_API(Main_OnCommand), FAKE_API(NamedCommandLookup), FAKE_API(GetToggleCommandState),
+        FAKE_API(MIDIEditor_GetActive), FAKE_API(MIDIEditor_OnCommand), FAKE_API(MIDIEditor_GetTake),
+        FAKE_API(MIDI_GetGrid), FAKE_API(MIDI_GetProjQNFromPPQPos), FAKE_API(MIDI_GetPPQPosFromProjQN),
+        FAKE_API(MIDI_EnumSelNotes), FAKE_API(MIDI_GetNote), FAKE_API(MIDI_SetNote), FAKE_API(MIDI_Sort),
+        FAKE_API(GetCursorPosition), FAKE_API(SetEditCurPos), FAKE_API(GetSet_LoopTimeRange),
+        FAKE_API(TimeMap2_timeToBeats), FAKE_API(TimeMap2_beatsToTime), FAKE_API(format_timestr_pos),
+        FAKE_API(PreventUIRefresh), FAKE_API(UpdateTimeline), FAKE_API(Undo_BeginBlock2), FAKE_API(Undo_EndBlock2),
+        FAKE_API(Undo_OnStateChangeEx2),
+        FAKE_API(mkvolstr), FAKE_API(mkpanstr), FAKE_API(osara_outputMessage),
+#undef FAKE_API
+    };
+    for (const auto& f : kApi) if (!strcmp(f.name, name)) return f.fn;
+    missing_functions++;
+    return MakeTrap(name);
+}
+
+static void* HostGetFunc(const char* name) { return FakeHost::Instance().GetFunc(name); }
+
+static int HostRegister(const char* name, void* info) {
+    if (!strcmp(name, "csurf_inst")) { FakeHost::Instance().surface = (IReaperControlSurface*)info; return 1; }
+    if (!strcmp(name, "-csurf_inst")) { FakeHost::Instance().surface = nullptr; return 1; }
+    return 0;
+}
+
+IReaperControlSurface* FakeHost::LoadPlugin() {
+    memset(&m_rec, 0, sizeof(m_rec));
+    m_rec.caller_version = REAPER_PLUGIN_VERSION;
+    m_rec.Register = HostRegister;
+    m_rec.GetFunc = HostGetFunc;
+    missing_functions = 0;
+    g_trap_count = 0;
+    if (!ReaperPluginEntry(nullptr, &m_rec)) return nullptr;
+    return surface;
+}
+
+void FakeHost::UnloadPlugin() {
+    ReaperPluginEntry(nullptr, nullptr);
+    surface = nullptr;
+}
+
+} // namespace fake_reaper
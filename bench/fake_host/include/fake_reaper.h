@@ -0,0 +1,140 @@
+#pragma once
+// --- FAKE REAPER HOST (headless, Linux) ---
+// In-process stand-in for the subset of the REAPER API that the surface uses:
+// tracks (vol/pan/solo/mute/name/selection), FX chains with named params,
+// selected items, the MIDI editor take (notes), the edit cursor, loop range and
+// a constant tempo map, the action dispatcher, the
+// MIDI output sink and speech.
+// The plugin is loaded through its real entry point: REAPERAPI_LoadAPI()
+// resolves every function pointer through FakeHost::GetFunc, and the surface
+// registered as "csurf_inst" is captured. Time is virtual (time_precise()
+// returns FakeHost::now), so a run is deterministic.
+//
+// Build (from the repo root), together with the plugin sources:
+//   g++ -O2 -std=c++17 -Ibench/fake_host/include -Iinclude -Isrc src/main.cpp src/csurf_soundfirst.cpp bench/fake_host/fake_reaper.cpp <driver>.cpp -lpthread
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "reaper_plugin.h"
+
+namespace fake_reaper {
+
+struct Param {
+    std::string name;
+    double value = 0.0;       // Normalized 0..1 (the fake has no native ranges)
+};
+
+struct FX {
+    std::string name;         // As TrackFX_GetFXName reports it, e.g. "VST3: Pro-Q 3 (FabFilter)"
+    bool enabled = true;
+    bool shown = false;
+    std::vector<Param> params;
+    double gain_reduction_db = 0.0; // "GainReduction_dB" named config parm (0 = not reported)
+};
+
+struct Track {
+    std::string name;
+    double vol = 1.0;
+    double pan = 0.0;
+    int solo = 0;
+    int mute = 0;
+    bool selected = false;
+    double peak[2] = { 0.0, 0.0 };  // Track_GetPeakInfo per channel
+    std::vector<FX> fx;
+};
+
+struct Item {
+    Track* track = nullptr;
+    double position = 0.0;
+    double length = 1.0;
+    double fade_in = 0.0;
+    double fade_out = 0.0;
+    double take_vol = 1.0;    // Active take D_VOL
+    double take_offset = 0.0; // Active take D_STARTOFFS (seconds)
+    double take_rate = 1.0;   // Active take D_PLAYRATE
+    bool selected = false;
+};
+
+struct Note {
+    double start = 0.0;       // PPQ (960 per quarter note, take starts at QN 0)
+    double end = 240.0;
+    int chan = 0;
+    int pitch = 60;
+    int vel = 100;
+    bool selected = false;
+    bool muted = false;
+};
+
+// Komplete Kontrol A-series report (fed to InjectHidReport): byte 1 buttons, byte 3 nav/modes,
+// bytes 4/5 touch, bytes 6-21 knob counters, byte 28 encoder counter
+struct Report {
+    unsigned char data[64];
+    Report() { memset(data, 0, sizeof(data)); data[0] = 0x01; }
+    void Knob(int k, int value) { data[6 + k * 2] = value & 0xFF; data[7 + k * 2] = (value >> 8) & 0x03; }
+    void Touch(int k, bool on) {
+        unsigned char& b = (k < 7) ? data[4] : data[5];
+        unsigned char bit = (k < 7) ? (unsigned char)(1 << (k + 1)) : 0x01;
+        b = on ? (b | bit) : (b & ~bit);
+    }
+};
+
+class FakeHost {
+public:
+    static FakeHost& Instance();
+
+    // --- Session ---
+    void Reset();                                  // Empty project, counters cleared, clock at 0
+    Track& AddTrack(const char* name);
+    FX& AddFX(int track, const char* name, int num_params);
+    Item& AddItem(int track, double position, double length);
+    void SelectOnlyTrack(int track);               // -1 clears the selection
+    int NumTracks() const { return (int)tracks.size(); }
+    Track& TrackAt(int i) { return *tracks[i]; }
+    int IndexOf(const Track* t) const;
+
+    // --- Clock ---
+    double now = 0.0;                              // time_precise()
+    void Advance(double seconds) { now += seconds; }
+
+    // --- Observed output ---
+    std::map<int, long> commands;                  // Main_OnCommand / MIDIEditor_OnCommand id -> count
+    long api_calls = 0;                            // Every fake API entry point bumps this
+    long midi_messages = 0;                        // Short messages + SysEx sent to the MIDI sink
+    long midi_bytes = 0;
+    std::vector<unsigned char> last_sysex;
+    std::vector<std::string> speech;               // osara_outputMessage
+    void ClearOutput();
+
+    // --- Plugin loading ---
+    void* GetFunc(const char* name);               // Host side of REAPERAPI_LoadAPI / rec->GetFunc
+    int missing_functions = 0;                     // Names the plugin asked for that the fake lacks
+    IReaperControlSurface* LoadPlugin();           // Calls ReaperPluginEntry(..., &rec)
+    void UnloadPlugin();                           // Calls ReaperPluginEntry(..., NULL)
+    IReaperControlSurface* surface = nullptr;
+
+    // --- State read by the fake API ---
+    std::vector<std::unique_ptr<Track>> tracks;
+    std::vector<std::unique_ptr<Item>> items;
+    bool midi_editor_open = false;
+    std::vector<Note> midi_notes;                  // The open editor's take
+    double midi_grid_qn = 0.25;                    // MIDI_GetGrid
+    long midi_sorts = 0;                           // MIDI_Sort calls (and sorting MIDI_SetNote calls)
+    std::string resource_path = ".";
+    double tempo_bpm = 120.0;                      // Constant tempo map, TimeMap2_* (beat = quarter note)
+    int beats_per_bar = 4;
+    double edit_cursor = 0.0;                      // GetCursorPosition / SetEditCurPos
+    double loop_start = 0.0, loop_end = 0.0;       // GetSet_LoopTimeRange
+    int last_touched_track = -1, last_touched_fx = -1, last_touched_param = -1;
+    int ui_refresh_prevented = 0;                  // PreventUIRefresh balance
+    int undo_blocks_open = 0;
+    long undo_points = 0;
+
+private:
+    FakeHost() {}
+    reaper_plugin_info_t m_rec;
+};
+
+} // namespace fake_reaper
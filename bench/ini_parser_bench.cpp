@@ -0,0 +1,93 @@
+// INI parser benchmark: legacy getline/substr/stoi loop vs IniFile (string_view + from_chars).
+// Synthetic corpus shaped like SoundFirst_PRO.ini plus many plugin / page sections.
+//
+//   g++ -O2 -std=c++17 -Isrc bench/ini_parser_bench.cpp -o ini_parser_bench
+//   ./ini_parser_bench [sections] [iterations]
+#include "ini_parser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+
+static std::string MakeCorpus(int sections) {
+    std::string s;
+    s += "; SoundFirst synthetic corpus\n[ACCESSIBILITY]\nAnnounceButtons=1\nAnnounceKnobs=1\n";
+    s += "[NHL_ACTIONS]\nPLAY=40044\nSTOP=1016\nREC=1013\n\n";
+    char line[128];
+    for (int i = 0; i < sections; i++) {
+        snprintf(line, sizeof(line), "[VST3: Synthetic Plugin %d (Vendor)]\n", i); s += line;
+        for (int k = 1; k <= 8; k++) {
+            snprintf(line, sizeof(line), "Knob%d=%d\nShiftKnob%d = %d\nTouch%d=%d\n", k, i + k, k, i * 2 + k, k, k * 3); s += line;
+        }
+        s += "PLAY=40044\nSTOP=1016\nLOOP=1068\n; comment line\n\n";
+        snprintf(line, sizeof(line), "[Page%d]\nName=Page %d\nK1=12\nk2_shift=7\nK3_TOUCH=9\n", (i % 8) + 1, i); s += line;
+    }
+    return s;
+}
+
+static std::string Trim(const std::string& str) {
+    size_t first = str.find_first_not_of(" \t\r\n");
+    if (std::string::npos == first) return str;
+    size_t last = str.find_last_not_of(" \t\r\n");
+    return str.substr(first, (last - first + 1));
+}
+
+// The pre-IniFile loader shape (per line: getline, trim copies, substr, stoi)
+static long long ParseLegacy(const char* path) {
+    std::ifstream f(path);
+    std::string line, sec;
+    long long sum = 0;
+    while (std::getline(f, line)) {
+        line = Trim(line); if (line.empty() || line[0] == ';') continue;
+        if (line[0] == '[' && line.back() == ']') { sec = Trim(line.substr(1, line.size() - 2)); continue; }
+        size_t eq = line.find('='); if (eq == std::string::npos) continue;
+        std::string k = Trim(line.substr(0, eq)), v = Trim(line.substr(eq + 1));
+        std::transform(k.begin(), k.end(), k.begin(), ::toupper);
+        try { sum += std::stoi(v); } catch (...) {}
+    }
+    return sum;
+}
+
+static long long ParseIniFile(const char* path) {
+    IniFile ini;
+    ini.Load(path);
+    long long sum = 0;
+    ini.ForEach([&](std::string_view, std::string_view, std::string_view v, int) {
+        int n = 0;
+        if (IniParseInt(v, n)) sum += n;
+    });
+    return sum;
+}
+
+template <typename Fn>
+static double TimeMs(Fn&& fn, int iterations, long long& check) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) check += fn();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / iterations;
+}
+
+int main(int argc, char** argv) {
+    int sections = (argc > 1) ? atoi(argv[1]) : 5000;
+    int iterations = (argc > 2) ? atoi(argv[2]) : 20;
+
+    const char* path = "ini_parser_bench_corpus.ini";
+    std::string corpus = MakeCorpus(sections);
+    { std::ofstream out(path, std::ios::binary); out << corpus; }
+    size_t lines = std::count(corpus.begin(), corpus.end(), '\n');
+
+    long long a = 0, b = 0;
+    double legacy = TimeMs([&] { return ParseLegacy(path); }, iterations, a);
+    double fast = TimeMs([&] { return ParseIniFile(path); }, iterations, b);
+    remove(path);
+
+    printf("corpus: %zu bytes, %zu lines, %d iterations\n", corpus.size(), lines, iterations);
+    printf("legacy getline/stoi : %8.3f ms/file  %6.1f ns/line\n", legacy, legacy * 1e6 / lines);
+    printf("IniFile string_view : %8.3f ms/file  %6.1f ns/line  (%.1fx)\n", fast, fast * 1e6 / lines, legacy / fast);
+    if (a != b) { printf("MISMATCH: %lld vs %lld\n", a, b); return 1; }
+    return 0;
+}
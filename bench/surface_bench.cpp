@@ -0,0 +1,298 @@
+// Microbenchmarks for the surface's hot paths, run against the fake host:
+//   HidDecode/*          HID thread: report -> HidFrame (+ queue push)
+//   HandleHidReport/*    Run(): one decoded frame, Mixer / PLUGIN mode, or a captured stream
+//   Run/*                one whole tick, idle and with 4 reports queued
+//   GetMapping/*         warm (cached), cold (factory), negative, and cold_map_file:
+//                        LoadMappingFromFile on a large map ([Page1..16], [Buttons], [Main])
+//   ParseConfig/large    SoundFirst_PRO.ini with many plugin sections (LoadMappingConfig)
+//   UpdateDisplay/*      steady state (nothing dirty) and one changed field
+//   SendLCDMessage       SysEx framing + send to the MIDI sink
+//
+//   g++ -O2 -DNDEBUG -std=c++17 -Ibench -Ibench/fake_host/include -Iinclude -Isrc src/main.cpp src/csurf_soundfirst.cpp bench/fake_host/fake_reaper.cpp bench/surface_bench.cpp -o surface_bench -lpthread
+//   ./surface_bench [--filter=SUBSTR] [--min_time=0.2] [--json=out.json] [--hid-capture=FILE]
+//
+// --hid-capture: one 64-byte report per line as hex ("01 00 00 ..." or "010000..."),
+// e.g. from a USB capture of a real session. '#' lines are ignored.
+#include "bench.h"
+#include "fake_reaper.h"
+#include "csurf_soundfirst.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using fake_reaper::FakeHost;
+using fake_reaper::Report;
+
+typedef std::vector<Report> ReportStream;
+
+// All 8 knobs turning, knob 1 touched half the time, the encoder stepping
+static ReportStream SyntheticStream(int count) {
+    ReportStream s;
+    Report r;
+    int knob[8] = { 0 };
+    for (int i = 0; i < count; i++) {
+        for (int k = 0; k < 8; k++) {
+            knob[k] = (knob[k] + 1 + k) & 0x3FF;
+            r.Knob(k, knob[k]);
+        }
+        r.Touch(0, (i % 64) < 32);
+        if (i % 8 == 0) r.data[28] = (unsigned char)(r.data[28] + 1);
+        s.push_back(r);
+    }
+    return s;
+}
+
+static bool LoadCapture(const char* path, ReportStream& out) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[1024];
+    while (fgets(line, sizeof(line), f)) {
+        if (line[0] == '#') continue;
+        Report r;
+        int n = 0;
+        for (const char* p = line; *p && n < 64; ) {
+            unsigned int b;
+            while (*p == ' ' || *p == '\t' || *p == ',') p++;
+            if (sscanf(p, "%2x", &b) != 1) break;
+            r.data[n++] = (unsigned char)b;
+            p += 2;
+        }
+        if (n > 0) out.push_back(r);
+    }
+    fclose(f);
+    return true;
+}
+
+static std::string TempDir() {
+    char tmpl[] = "/tmp/sfbench.XXXXXX";
+    return mkdtemp(tmpl) ? std::string(tmpl) : std::string("/tmp");
+}
+
+static void WriteFile(const std::string& path, const std::string& text) {
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) return;
+    fwrite(text.data(), 1, text.size(), f);
+    fclose(f);
+}
+
+// Friend of CSurf_SoundFirst: reaches the private handlers the benchmarks time
+struct SurfaceBench {
+    static CSurf_SoundFirst* surface;
+
+    static void Handle(const HidFrame& f) { surface->HandleHidReport(f); }
+    static void EndDrain() { surface->ApplyGangDeltas(); }
+    static void SetMode(CSurf_SoundFirst::ControlMode m) { surface->m_current_mode = m; }
+    static void KeepAwake() { surface->m_last_input_time = time_precise(); surface->m_screensaver_active = false; }
+    static void UpdateDisplay() { surface->UpdateDisplay(); }
+    static void InvalidateVolume() { surface->m_display.Invalidate(DisplayModel::FIELD_VOLUME); }
+    static void SendLCD(const char* text) { surface->SendLCDMessage(0x48, text); }
+    static ConfigPtr ParseConfig(const std::string& path) { return CSurf_SoundFirst::ParseConfig(path); }
+};
+CSurf_SoundFirst* SurfaceBench::surface = nullptr;
+
+static std::vector<HidFrame> Decode(const ReportStream& s) {
+    HidDecoder dec;
+    std::vector<HidFrame> frames(s.size());
+    for (size_t i = 0; i < s.size(); i++) dec.Decode(s[i].data, frames[i]);
+    return frames;
+}
+
+// Frames are replayed in a loop; the gang deltas are applied every 4 frames, as one Run() drain would
+static void ReplayFrames(BenchState& st, const std::vector<HidFrame>& frames) {
+    if (frames.empty()) { st.SkipWithError("empty stream"); return; }
+    size_t i = 0;
+    while (st.KeepRunning()) {
+        SurfaceBench::Handle(frames[i]);
+        if ((++i & 3) == 0) SurfaceBench::EndDrain();
+        if (i == frames.size()) i = 0;
+    }
+    st.SetItemsProcessed(st.iterations());
+}
+
+int main(int argc, char** argv) {
+    const char* capture_path = nullptr;
+    for (int i = 1; i < argc; i++) {
+        if (!strncmp(argv[i], "--hid-capture=", 14)) capture_path = argv[i] + 14;
+    }
+
+    FakeHost& host = FakeHost::Instance();
+    host.Reset();
+    for (int i = 0; i < 64; i++) {
+        char name[32]; snprintf(name, sizeof(name), "Track %d", i + 1);
+        host.AddTrack(name);
+        host.AddFX(i, "VST3: Pro-Q 3 (FabFilter)", 200);
+        host.AddFX(i, "VST3: Lindell 50 Channel (Plugin Alliance)", 80);
+    }
+    host.SelectOnlyTrack(0);
+
+    // Map files are read from %APPDATA%\REAPER\UserPlugins\SoundFirst_Maps\ ; on Linux the
+    // backslashes are part of a plain file name inside the temp directory
+    std::string dir = TempDir();
+    std::string appdata = dir + "/appdata";
+    setenv("APPDATA", appdata.c_str(), 1);
+    std::string map_prefix = appdata + "\\REAPER\\UserPlugins\\SoundFirst_Maps\\";
+
+    host.resource_path = dir;
+    CSurf_SoundFirst* surface = static_cast<CSurf_SoundFirst*>(host.LoadPlugin());
+    if (!surface) { fprintf(stderr, "plugin did not load\n"); return 1; }
+    SurfaceBench::surface = surface;
+
+    BenchRunner runner;
+    runner.ParseArgs(argc, argv);
+
+    // --- HID ---
+    const ReportStream synthetic = SyntheticStream(4096);
+    runner.Register("HidDecode/synthetic", [&](BenchState& st) {
+        HidDecoder dec;
+        HidFrameQueue queue;
+        std::vector<HidFrame> drained;
+        HidFrame f;
+        size_t i = 0;
+        while (st.KeepRunning()) {
+            dec.Decode(synthetic[i].data, f);
+            queue.Push(f);
+            if (++i == synthetic.size()) { i = 0; queue.Drain(drained); }
+        }
+        st.SetItemsProcessed(st.iterations());
+    });
+
+    const std::vector<HidFrame> synthetic_frames = Decode(synthetic);
+    runner.Register("HandleHidReport/synthetic_mixer", [&](BenchState& st) {
+        SurfaceBench::SetMode(CSurf_SoundFirst::MODE_MIXER);
+        ReplayFrames(st, synthetic_frames);
+    });
+    runner.Register("HandleHidReport/synthetic_plugin", [&](BenchState& st) {
+        SurfaceBench::SetMode(CSurf_SoundFirst::MODE_FX);
+        ReplayFrames(st, synthetic_frames);
+        SurfaceBench::SetMode(CSurf_SoundFirst::MODE_MIXER);
+    });
+
+    ReportStream captured;
+    if (capture_path && !LoadCapture(capture_path, captured)) fprintf(stderr, "cannot read %s\n", capture_path);
+    const std::vector<HidFrame> captured_frames = Decode(captured);
+    if (capture_path) {
+        runner.Register("HandleHidReport/captured", [&](BenchState& st) {
+            st.SetLabel(capture_path);
+            ReplayFrames(st, captured_frames);
+        });
+    }
+
+    runner.Register("Run/idle", [&](BenchState& st) {
+        while (st.KeepRunning()) {
+            host.Advance(1.0 / 30.0);
+            surface->Run();
+        }
+    });
+    runner.Register("Run/4_reports", [&](BenchState& st) {
+        size_t i = 0;
+        while (st.KeepRunning()) {
+            for (int sub = 0; sub < 4; sub++) {
+                surface->InjectHidReport(synthetic[i].data, 64);
+                if (++i == synthetic.size()) i = 0;
+            }
+            host.Advance(1.0 / 30.0);
+            surface->Run();
+        }
+        st.SetItemsProcessed(st.iterations() * 4);
+    });
+
+    // --- Mapping lookups ---
+    const char* kFactory = "VST3: Lindell 50 Channel (Plugin Alliance)";
+    const char* kUnmapped = "VST3: Pro-Q 3 (FabFilter)";
+    runner.Register("GetMapping/warm", [&](BenchState& st) {
+        FXMappingRegistry::GetMapping(kFactory);
+        while (st.KeepRunning()) FXMappingRegistry::GetMapping(kFactory);
+    });
+    runner.Register("GetMapping/negative_warm", [&](BenchState& st) {
+        FXMappingRegistry::GetMapping(kUnmapped);
+        while (st.KeepRunning()) FXMappingRegistry::GetMapping(kUnmapped);
+    });
+    // Cold: the cache is dropped before every lookup (SetConfigMappings clears it)
+    runner.Register("GetMapping/cold_factory", [&](BenchState& st) {
+        while (st.KeepRunning()) {
+            st.PauseTiming(); FXMappingRegistry::SetConfigMappings(nullptr); st.ResumeTiming();
+            FXMappingRegistry::GetMapping(kFactory);
+        }
+    });
+    runner.Register("GetMapping/negative_cold", [&](BenchState& st) {
+        while (st.KeepRunning()) {
+            st.PauseTiming(); FXMappingRegistry::SetConfigMappings(nullptr); st.ResumeTiming();
+            FXMappingRegistry::GetMapping(kUnmapped);
+        }
+    });
+
+    // Map file: 16 pages x 8 knobs (+ shift / touch), buttons and meter settings
+    std::string big_map = "[Main]\nPluginName=VST3: Bench Map (Bench)\nMeterParam=7\nMeterRangeDb=24\n\n[Buttons]\n";
+    big_map += "LOOP=40044\nMETRO=40364\nTEMPO=1134\nMUTE=@TOGGLE_BYPASS\nSOLO=@REPORT_PEAK\nPRESET_UP=@PAGE_UP\n\n";
+    for (int p = 1; p <= 16; p++) {
+        char buf[128];
+        snprintf(buf, sizeof(buf), "[Page%d]\nName=Page %d\n", p, p); big_map += buf;
+        for (int k = 1; k <= 8; k++) {
+            snprintf(buf, sizeof(buf), "K%d=%d\nK%d_SHIFT=%d\nK%d_TOUCH=%d\n", k, p * 8 + k, k, 500 + p * 8 + k, k, 900 + k);
+            big_map += buf;
+        }
+        big_map += "\n";
+    }
+    WriteFile(map_prefix + "Bench Map.ini", big_map);
+    runner.Register("GetMapping/cold_map_file", [&](BenchState& st) {
+        while (st.KeepRunning()) {
+            st.PauseTiming(); FXMappingRegistry::SetConfigMappings(nullptr); st.ResumeTiming();
+            if (!FXMappingRegistry::GetMapping("VST3: Bench Map (Bench)")) { st.SkipWithError("map file not found"); break; }
+        }
+        st.SetItemsProcessed(st.iterations() * (long)big_map.size());  // bytes/s
+    });
+
+    // SoundFirst_PRO.ini: the regular sections plus 500 legacy plugin sections
+    std::string big_cfg = "[ACCESSIBILITY]\nAnnounceButtons=1\nAnnounceKnobs=1\n\n[METER]\nRateHz=30\n\n[PERFORMANCE]\nTickBudgetMs=1\n\n";
+    big_cfg += "[MODES]\nMode1=MIXER\nMode2=PLUGIN\nMode3=MIDI\nMode4=AUDIO\n\n[NHL_ACTIONS]\nPLAY=40044\nSTOP=1016\nLOOP=1068\n\n";
+    for (int s = 0; s < 500; s++) {
+        char buf[160];
+        snprintf(buf, sizeof(buf), "[VST3: Plugin %03d (Vendor)]\n", s); big_cfg += buf;
+        for (int k = 1; k <= 8; k++) {
+            snprintf(buf, sizeof(buf), "Knob%d=%d\nShiftKnob%d=%d\nTouch%d=%d\n", k, k, k, 100 + k, k, 200 + k);
+            big_cfg += buf;
+        }
+        big_cfg += "PLAY=40044\nMUTE=@TOGGLE_BYPASS\n\n";
+    }
+    const std::string cfg_path = dir + "/SoundFirst_PRO.ini";
+    WriteFile(cfg_path, big_cfg);
+    runner.Register("ParseConfig/large", [&](BenchState& st) {
+        while (st.KeepRunning()) {
+            if (!SurfaceBench::ParseConfig(cfg_path)) { st.SkipWithError("ParseConfig failed"); break; }
+        }
+        st.SetItemsProcessed(st.iterations() * (long)big_cfg.size());  // bytes/s
+    });
+
+    // --- Display ---
+    runner.Register("UpdateDisplay/steady", [&](BenchState& st) {
+        SurfaceBench::KeepAwake();
+        SurfaceBench::UpdateDisplay();
+        while (st.KeepRunning()) SurfaceBench::UpdateDisplay();
+    });
+    runner.Register("UpdateDisplay/volume_change", [&](BenchState& st) {
+        SurfaceBench::KeepAwake();
+        long i = 0;
+        while (st.KeepRunning()) {
+            host.TrackAt(0).vol = (++i & 1) ? 0.5 : 1.0;
+            SurfaceBench::InvalidateVolume();
+            SurfaceBench::UpdateDisplay();
+        }
+    });
+    runner.Register("SendLCDMessage", [&](BenchState& st) {
+        while (st.KeepRunning()) SurfaceBench::SendLCD("Track 1 - Vocals                ");
+        st.SetItemsProcessed(st.iterations());
+    });
+
+    int rc = runner.RunAll();
+
+    host.UnloadPlugin();
+    remove((map_prefix + "Bench Map.ini").c_str());
+    remove(cfg_path.c_str());
+    remove((appdata + "\\REAPER\\UserPlugins\\SoundFirst_Logs.txt").c_str());
+    rmdir(dir.c_str());
+    return rc;
+}
@@ -0,0 +1,135 @@
+#pragma once
+#include <cstring>
+#include <mutex>
+
+// Speech announcements for ONE surface instance.
+// Producers post into a category; a newer post replaces the pending text of
+// its category (last writer wins). Once per Run() tick, everything whose dwell
+// time has elapsed is joined into a single utterance, so the screen reader gets
+// at most one message per tick and never a backlog of stale positions.
+struct AnnouncementScheduler {
+    enum Category {
+        ANNOUNCE_STATUS = 0,   // Mode changes, toggles, confirmations (spoken first)
+        ANNOUNCE_NAVIGATION,   // Bank, track, FX, page, marker position
+        ANNOUNCE_VALUE,        // Parameter / level readouts
+        NUM_CATEGORIES
+    };
+
+    struct Slot {
+        char text[256];
+        bool pending = false;
+        double posted_at = 0.0;
+        double dwell = 0.0;    // Seconds the text must stay unreplaced before it is spoken
+    };
+
+    Slot slots[NUM_CATEGORIES];
+    std::mutex lock; // Post() can come from the HID thread
+
+    AnnouncementScheduler() {
+        for (int i = 0; i < NUM_CATEGORIES; i++) slots[i].text[0] = 0;
+        slots[ANNOUNCE_NAVIGATION].dwell = 0.15; // Fast encoder spins only speak where they stop
+    }
+
+    void SetDwell(int category, double seconds) {
+        if (category < 0 || category >= NUM_CATEGORIES) return;
+        std::lock_guard<std::mutex> guard(lock);
+        slots[category].dwell = (seconds > 0.0) ? seconds : 0.0;
+    }
+
+    void Post(int category, const char* text, double now) {
+        if (!text || !text[0] || category < 0 || category >= NUM_CATEGORIES) return;
+        std::lock_guard<std::mutex> guard(lock);
+        Slot& s = slots[category];
+        strncpy(s.text, text, sizeof(s.text) - 1);
+        s.text[sizeof(s.text) - 1] = 0;
+        s.pending = true;
+        s.posted_at = now;
+    }
+
+    // Joins the pending categories (priority order) into out; false when nothing is due.
+    // Once one category is due, the others ride along in the same utterance instead
+    // of being spoken a few ticks later and cutting it off.
+    bool Collect(double now, char* out, size_t cap) {
+        if (cap == 0) return false;
+        std::lock_guard<std::mutex> guard(lock);
+        bool due = false;
+        for (int i = 0; i < NUM_CATEGORIES; i++) {
+            if (slots[i].pending && now - slots[i].posted_at >= slots[i].dwell) due = true;
+        }
+        if (!due) return false;
+
+        size_t n = 0;
+        out[0] = 0;
+        for (int i = 0; i < NUM_CATEGORIES; i++) {
+            Slot& s = slots[i];
+            if (!s.pending) continue;
+            s.pending = false;
+            if (n > 0 && n + 2 < cap) { out[n++] = ','; out[n++] = ' '; }
+            for (const char* p = s.text; *p && n + 1 < cap; p++) out[n++] = *p;
+            out[n] = 0;
+        }
+        return n > 0;
+    }
+};
+
+// Spoken values for knob gestures. Each knob remembers what it last adjusted;
+// while it moves, the formatted value is sampled at most once per interval, and
+// the exact value is spoken when the knob is released (touch bit cleared, or
+// idle_timeout for turns without touch). Source ACTION covers button-driven
+// @FX_PARAM_* changes, which have no touch and always end by timeout.
+struct KnobValueAnnouncer {
+    enum Target {
+        TARGET_NONE = 0,
+        TARGET_FX_PARAM,      // obj = MediaTrack*, fx, param
+        TARGET_TRACK_VOLUME,  // obj = MediaTrack*
+        TARGET_TRACK_PAN,     // obj = MediaTrack*
+        TARGET_TAKE_VOLUME,   // obj = first selected MediaItem* (active take)
+        TARGET_FADE_IN,       // obj = first selected MediaItem*
+        TARGET_FADE_OUT
+    };
+    static const int NUM_KNOBS = 8;
+    static const int SOURCE_ACTION = NUM_KNOBS;
+
+    struct Source {
+        int target = TARGET_NONE;
+        void* obj = nullptr;
+        int fx = -1;
+        int param = -1;
+        bool moved = false;        // Changed since the last spoken sample
+        double next_sample = 0.0;  // Throttle: earliest time for the next in-gesture sample
+        double last_move = 0.0;
+    };
+
+    Source sources[NUM_KNOBS + 1];
+    double interval = 0.25;     // [ACCESSIBILITY] ValueIntervalMs
+    double idle_timeout = 0.5;  // Release fallback without touch
+
+    // Records a change; true when an in-gesture sample is due
+    bool Moved(int src, int target, void* obj, int fx, int param, double now) {
+        if (src < 0 || src > NUM_KNOBS) return false;
+        Source& s = sources[src];
+        if (s.target != target || s.obj != obj || s.fx != fx || s.param != param) s.next_sample = 0.0; // New target: sample now
+        s.target = target; s.obj = obj; s.fx = fx; s.param = param;
+        s.last_move = now;
+        if (now < s.next_sample) { s.moved = true; return false; }
+        s.next_sample = now + interval;
+        s.moved = false; // The caller speaks this sample
+        return true;
+    }
+
+    // Touch release; true when the final value differs from the last sample spoken
+    bool Released(int src) {
+        if (src < 0 || src > NUM_KNOBS) return false;
+        Source& s = sources[src];
+        bool speak = s.moved && s.next_sample > 0.0;
+        s.moved = false;
+        s.next_sample = 0.0;
+        return speak && s.target != TARGET_NONE;
+    }
+
+    // Untouched sources idle past the timeout; true when src must be released
+    bool IdleExpired(int src, double now) const {
+        const Source& s = sources[src];
+        return s.next_sample > 0.0 && now - s.last_move > idle_timeout;
+    }
+};
@@ -0,0 +1,211 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// --- REAPER API CALL TRACER ---
+// Optional shim around the API function pointers that REAPERAPI_LoadAPI filled:
+// Enable(true) swaps each traced pointer for a wrapper that counts the call and
+// its wall time, then calls the original. Calls are bucketed by the surface
+// method that made them (innermost SF_API_SCOPE on the calling thread), so a
+// dump shows which handler hammers the host. Enable(false) restores the
+// original pointers; with tracing off a scope costs one thread_local swap.
+// [PERFORMANCE] ApiTrace=1 turns it on, the @DUMP_API_TRACE action writes the table.
+
+// Functions the surface calls on the UI thread. Not traced: osara_outputMessage
+// (resolved separately) and time_precise, which the HID thread also calls
+// (SpeakText -> Announce) and could race a hook swap.
+#define SF_TRACED_API(X) \
+    X(ShowConsoleMsg) X(GetResourcePath) \
+    X(GetNumMIDIInputs) X(GetNumMIDIOutputs) X(GetMIDIInputName) X(GetMIDIOutputName) \
+    X(CreateMIDIInput) X(CreateMIDIOutput) \
+    X(CountTracks) X(GetTrack) X(GetMasterTrack) X(CSurf_TrackFromID) X(CountSelectedTracks) X(GetSelectedTrack) \
+    X(SetOnlyTrackSelected) \
+    X(GetLastTouchedTrack) \
+    X(GetMediaTrackInfo_Value) X(SetMediaTrackInfo_Value) X(GetSetMediaTrackInfo) X(Track_GetPeakInfo) \
+    X(TrackFX_GetCount) X(TrackFX_GetFXName) X(TrackFX_GetNumParams) X(TrackFX_GetParam) \
+    X(TrackFX_GetParamNormalized) X(TrackFX_SetParam) X(TrackFX_GetParamName) \
+    X(TrackFX_GetFormattedParamValue) X(TrackFX_GetNamedConfigParm) \
+    X(TrackFX_GetEnabled) X(TrackFX_SetEnabled) X(TrackFX_GetOpen) X(TrackFX_SetOpen) X(TrackFX_Show) \
+    X(CountSelectedMediaItems) X(GetSelectedMediaItem) X(GetActiveTake) \
+    X(GetMediaItemInfo_Value) X(SetMediaItemInfo_Value) \
+    X(GetMediaItemTakeInfo_Value) X(SetMediaItemTakeInfo_Value) X(ValidatePtr2) \
+    X(Main_OnCommand) X(NamedCommandLookup) X(GetToggleCommandState) \
+    X(MIDIEditor_GetActive) X(MIDIEditor_OnCommand) X(MIDIEditor_GetTake) \
+    X(MIDI_GetGrid) X(MIDI_GetProjQNFromPPQPos) X(MIDI_GetPPQPosFromProjQN) \
+    X(MIDI_EnumSelNotes) X(MIDI_GetNote) X(MIDI_SetNote) X(MIDI_Sort) \
+    X(GetCursorPosition) X(SetEditCurPos) X(GetSet_LoopTimeRange) \
+    X(TimeMap2_timeToBeats) X(TimeMap2_beatsToTime) X(format_timestr_pos) \
+    X(PreventUIRefresh) X(UpdateTimeline) X(Undo_BeginBlock2) X(Undo_EndBlock2) X(Undo_OnStateChangeEx2) \
+    X(mkvolstr) X(mkpanstr)
+
+class ApiTracer {
+public:
+    enum Function {
+#define SF_API_ENUM(name) API_##name,
+        SF_TRACED_API(SF_API_ENUM)
+#undef SF_API_ENUM
+        NUM_FUNCTIONS
+    };
+    enum { MAX_SCOPES = 64 };  // Scope 0 = calls outside any SF_API_SCOPE
+
+    // Call-site id of a scope name (__func__), registered once per call site
+    static int ScopeId(const char* name) {
+        std::lock_guard<std::mutex> l(Lock());
+        Table& t = Stats();
+        for (int i = 1; i < t.num_scopes; i++) {
+            if (t.scope_names[i] == name) return i;
+        }
+        if (t.num_scopes >= MAX_SCOPES) return 0;
+        t.scope_names[t.num_scopes] = name;
+        return t.num_scopes++;
+    }
+
+    static int& CurrentScope() {
+        static thread_local int scope = 0;
+        return scope;
+    }
+
+    static void Record(int fn, double seconds) {
+        Cell& c = Stats().cells[CurrentScope()][fn];
+        c.calls.fetch_add(1, std::memory_order_relaxed);
+        c.nanos.fetch_add((unsigned long long)(seconds * 1e9), std::memory_order_relaxed);
+    }
+
+    // UI thread only (ApplyConfig); never from inside a traced call
+    static void Enable(bool on);
+    static bool Enabled() { return Stats().enabled; }
+
+    static void Reset() {
+        Table& t = Stats();
+        for (int s = 0; s < MAX_SCOPES; s++) {
+            for (int f = 0; f < NUM_FUNCTIONS; f++) {
+                t.cells[s][f].calls.store(0, std::memory_order_relaxed);
+                t.cells[s][f].nanos.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // One line per (scope, function) with calls, sorted by total time, then per-function totals
+    static std::string Dump() {
+        struct Row { const char* scope; const char* fn; unsigned long long calls, nanos; };
+        static const char* kNames[NUM_FUNCTIONS] = {
+#define SF_API_NAME(name) #name,
+            SF_TRACED_API(SF_API_NAME)
+#undef SF_API_NAME
+        };
+        Table& t = Stats();
+        std::vector<Row> rows;
+        Row totals[NUM_FUNCTIONS] = {};
+        int num_scopes;
+        {
+            std::lock_guard<std::mutex> l(Lock());
+            num_scopes = t.num_scopes;
+        }
+        for (int s = 0; s < num_scopes; s++) {
+            for (int f = 0; f < NUM_FUNCTIONS; f++) {
+                unsigned long long calls = t.cells[s][f].calls.load(std::memory_order_relaxed);
+                if (!calls) continue;
+                unsigned long long nanos = t.cells[s][f].nanos.load(std::memory_order_relaxed);
+                rows.push_back({ s ? t.scope_names[s] : "(no scope)", kNames[f], calls, nanos });
+                totals[f].fn = kNames[f];
+                totals[f].calls += calls;
+                totals[f].nanos += nanos;
+            }
+        }
+        auto by_time = [](const Row& a, const Row& b) { return a.nanos > b.nanos; };
+        std::sort(rows.begin(), rows.end(), by_time);
+        std::sort(totals, totals + NUM_FUNCTIONS, by_time);
+
+        std::string out;
+        char line[256];
+        snprintf(line, sizeof(line), "%-28s %-32s %10s %12s %10s\n", "Scope", "Function", "Calls", "Total us", "Avg ns");
+        out += line;
+        for (const Row& r : rows) {
+            snprintf(line, sizeof(line), "%-28s %-32s %10llu %12.1f %10.0f\n", r.scope, r.fn, r.calls,
+                     r.nanos / 1000.0, (double)r.nanos / (double)r.calls);
+            out += line;
+        }
+        out += "\n";
+        for (const Row& r : totals) {
+            if (!r.calls) continue;
+            snprintf(line, sizeof(line), "%-28s %-32s %10llu %12.1f %10.0f\n", "(all)", r.fn, r.calls,
+                     r.nanos / 1000.0, (double)r.nanos / (double)r.calls);
+            out += line;
+        }
+        return out;
+    }
+
+private:
+    struct Cell {
+        std::atomic<unsigned long long> calls{ 0 };
+        std::atomic<unsigned long long> nanos{ 0 };
+    };
+    struct Table {
+        bool enabled = false;
+        int num_scopes = 1;
+        const char* scope_names[MAX_SCOPES] = { "" };
+        Cell cells[MAX_SCOPES][NUM_FUNCTIONS];
+    };
+    static Table& Stats() { static Table t; return t; }
+    static std::mutex& Lock() { static std::mutex m; return m; }
+};
+
+// Innermost surface method on this thread; restores the caller's scope on exit
+class ApiTraceScope {
+public:
+    explicit ApiTraceScope(int id) : m_prev(ApiTracer::CurrentScope()) { ApiTracer::CurrentScope() = id; }
+    ~ApiTraceScope() { ApiTracer::CurrentScope() = m_prev; }
+private:
+    int m_prev;
+};
+
+#define SF_API_SCOPE() \
+    static const int sf_api_scope_id_ = ApiTracer::ScopeId(__func__); \
+    ApiTraceScope sf_api_scope_(sf_api_scope_id_)
+
+// Wrapper for one API pointer: Ptr is the address of the global function pointer
+template <auto Ptr> struct ApiTraceHook;
+template <typename R, typename... A, R (**Ptr)(A...)>
+struct ApiTraceHook<Ptr> {
+    static inline R (*original)(A...) = nullptr; // Kept after Uninstall: a call already in flight still has its target
+    static inline bool installed = false;
+    static inline int fn = 0;
+
+    static R Call(A... args) {
+        struct Timer {
+            int fn;
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            ~Timer() { ApiTracer::Record(fn, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()); }
+        } timer{ fn };
+        return original(args...);
+    }
+
+    static void Install(int id) {
+        if (installed || !*Ptr) return;  // Already hooked / not provided by this REAPER
+        fn = id;
+        original = *Ptr;
+        installed = true;
+        *Ptr = &Call;
+    }
+
+    static void Uninstall() {
+        if (!installed) return;
+        *Ptr = original;
+        installed = false;
+    }
+};
+
+inline void ApiTracer::Enable(bool on) {
+    Table& t = Stats();
+    if (on == t.enabled) return;
+    t.enabled = on;
+#define SF_API_HOOK(name) \
+    if (on) ApiTraceHook<&name>::Install(API_##name); else ApiTraceHook<&name>::Uninstall();
+    SF_TRACED_API(SF_API_HOOK)
+#undef SF_API_HOOK
+}
@@ -0,0 +1,190 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include "fx_mappings.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#elif defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+// Immutable snapshot of SoundFirst_PRO.ini. Built on the watcher thread and
+// published whole, so the main thread never sees a half-parsed file and never
+// parses on its own. Scalar settings use -1 for "key absent": the surface then
+// keeps its current value, as the in-place loader did.
+struct Config {
+    std::map<std::string, std::string> nhl_actions;                  // [NHL_ACTIONS] over built-in defaults
+    std::map<int, std::map<std::string, std::string>> mode_actions;  // ControlMode -> [MODE_*] actions
+    FXMappingTable plugin_mappings;                                  // Legacy per-plugin sections
+    std::vector<std::string> modes;                                  // [MODES] (empty = not set)
+
+    // [ACCESSIBILITY]
+    int announce_buttons = -1;
+    int announce_knobs = -1;
+    int announce_encoder = -1;
+    int announce_actions = -1;
+    int touch_auto_solo = -1;
+    double navigation_dwell_ms = -1.0;
+    double value_interval_ms = -1.0;
+    double value_dwell_ms = -1.0;
+
+    // [METER]
+    double gr_rate_hz = -1.0;
+    double gr_range_db = -1.0;
+    double rate_hz = -1.0;
+    double attack_ms = -1.0;
+    double hold_ms = -1.0;
+    double release_db_per_sec = -1.0;
+
+    // [ENCODER]
+    double encoder_bar_rate = -1.0;
+    double encoder_section_rate = -1.0;
+    int encoder_bars_per_section = -1;
+    double track_repeat_ms = -1.0;
+    int track_max_jump = -1;
+
+    // [AUDIO]
+    double item_step_ms = -1.0;
+
+    // [MIDI]
+    int note_step_counts = -1;
+
+    // [PERFORMANCE]
+    double tick_budget_ms = -1.0;
+    int api_trace = -1;             // 1 = trace REAPER API calls (see api_trace.h)
+
+    // [LOGGING]
+    int log_level = -1;
+    int log_categories = -1;
+    long log_max_kb = -1;
+};
+
+typedef std::shared_ptr<const Config> ConfigPtr;
+
+// Watches the INI's directory and republishes a parsed snapshot on change.
+// Windows: FindFirstChangeNotification. Linux: inotify. Anything else, or if
+// the notification handle cannot be created: mtime polling once per second.
+// Readers call Latest() every tick (one atomic pointer load) and Snapshot()
+// only when it differs from the snapshot they hold.
+class ConfigWatcher {
+public:
+    typedef ConfigPtr (*Parser)(const std::string& path);
+
+    ConfigWatcher() : m_latest(nullptr), m_running(false) {}
+    ~ConfigWatcher() { Stop(); }
+
+    void Start(const std::string& path, Parser parser, ConfigPtr initial) {
+        if (m_running || path.empty() || !parser) return;
+        m_path = path;
+        m_parser = parser;
+        Publish(initial);
+        m_last_stamp = FileStamp();
+#ifdef _WIN32
+        m_stop_event = CreateEventA(NULL, TRUE, FALSE, NULL); // Before the thread: Stop() may follow at once
+#endif
+        m_running = true;
+        m_thread = std::thread(&ConfigWatcher::ThreadLoop, this);
+    }
+
+    void Stop() {
+        if (!m_running) return;
+        m_running = false;
+#ifdef _WIN32
+        if (m_stop_event) SetEvent(m_stop_event);
+#endif
+        if (m_thread.joinable()) m_thread.join();
+#ifdef _WIN32
+        if (m_stop_event) { CloseHandle(m_stop_event); m_stop_event = NULL; }
+#endif
+    }
+
+    const Config* Latest() const { return m_latest.load(std::memory_order_acquire); }
+    ConfigPtr Snapshot() const { return std::atomic_load(&m_published); }
+
+private:
+    std::string m_path;
+    Parser m_parser = nullptr;
+    ConfigPtr m_published;                  // Accessed with std::atomic_load / atomic_store
+    std::atomic<const Config*> m_latest;    // Identity of m_published, for the per-tick check
+    std::atomic<bool> m_running;
+    std::thread m_thread;
+    long long m_last_stamp = 0;
+#ifdef _WIN32
+    HANDLE m_stop_event = NULL;
+#endif
+
+    void Publish(ConfigPtr cfg) {
+        if (!cfg) return;
+        std::atomic_store(&m_published, cfg);
+        m_latest.store(cfg.get(), std::memory_order_release);
+    }
+
+    // mtime + size: cheap change test, only done after a notification (or poll)
+    long long FileStamp() const {
+        struct stat st;
+        if (stat(m_path.c_str(), &st) != 0) return 0;
+        return ((long long)st.st_mtime << 20) ^ (long long)st.st_size;
+    }
+
+    void ReloadIfChanged() {
+        // Editors save in several steps (truncate, write, rename): let it settle
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        long long stamp = FileStamp();
+        if (stamp == 0 || stamp == m_last_stamp) return;
+        m_last_stamp = stamp;
+        Publish(m_parser(m_path));
+    }
+
+    std::string Directory() const {
+        size_t slash = m_path.find_last_of("\\/");
+        return (slash == std::string::npos) ? std::string(".") : m_path.substr(0, slash);
+    }
+
+    void ThreadLoop() {
+#ifdef _WIN32
+        HANDLE change = FindFirstChangeNotificationA(Directory().c_str(), FALSE,
+                                                     FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+        if (change != INVALID_HANDLE_VALUE && m_stop_event) {
+            HANDLE handles[2] = { change, m_stop_event };
+            while (m_running) {
+                DWORD r = WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+                if (r != WAIT_OBJECT_0 || !m_running) break;
+                ReloadIfChanged();
+                if (!FindNextChangeNotification(change)) break;
+            }
+            FindCloseChangeNotification(change);
+            return;
+        }
+        if (change != INVALID_HANDLE_VALUE) FindCloseChangeNotification(change);
+#elif defined(__linux__)
+        int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd >= 0 && inotify_add_watch(fd, Directory().c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) >= 0) {
+            char buf[4096];
+            while (m_running) {
+                struct pollfd p = { fd, POLLIN, 0 };
+                if (poll(&p, 1, 250) <= 0) continue; // Timeout: re-check m_running
+                while (read(fd, buf, sizeof(buf)) > 0) {} // Drain; the stamp decides
+                ReloadIfChanged();
+            }
+            close(fd);
+            return;
+        }
+        if (fd >= 0) close(fd);
+#endif
+        // Polling fallback
+        while (m_running) {
+            for (int i = 0; i < 10 && m_running; i++) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            if (m_running && FileStamp() != m_last_stamp) ReloadIfChanged();
+        }
+    }
+};
@@ -5,7 +5,6 @@
 */
 
 #include "csurf_soundfirst.h"
-#include <windows.h>
 #include <stdio.h>
 #include <cmath>
 #include <string>
@@ -17,6 +16,8 @@
 #include <algorithm>
 #include <cctype>
 #include "fx_mappings.h" // V3 Pro FX Mapping Engine
+#include "logger.h"      // Async ring-buffer logger
+#include "ini_parser.h"  // Shared zero-copy INI reader
 
 #ifdef _WIN32
 #include <windows.h>
@@ -29,58 +30,56 @@
 
 // --- GLOBALS/HELPERS ---
 
-std::map<std::string, std::map<int, int>> g_plugin_mappings;
-std::map<std::string, std::map<int, std::string>> g_page_names;
-
 // Global REAPER Plugin Info
-extern "C" void RawLog(const char* txt);
 extern reaper_plugin_info_t* g_rec;
 
-static std::string trim(const std::string& str) {
-    size_t first = str.find_first_not_of(" \t\r\n");
-    if (std::string::npos == first) return str;
-    size_t last = str.find_last_not_of(" \t\r\n");
-    return str.substr(first, (last - first + 1));
-}
-
-void AutoDetectSoundFirstPorts(int& inDev, int& outDev) {
-    inDev = -1; outDev = -1;
-    int num_inputs = GetNumMIDIInputs();
-    for (int i = 0; i < num_inputs; i++) {
-        char name[256];
-        if (GetMIDIInputName(i, name, sizeof(name))) {
-            if (strstr(name, "Komplete") && strstr(name, "DAW")) { inDev = i; break; }
-        }
-    }
-    int num_outputs = GetNumMIDIOutputs();
-    for (int i = 0; i < num_outputs; i++) {
+// The device's DAW port: the n-th "Komplete ... DAW" port carrying its model tag (n = ordinal
+// among keyboards of that model), else the first untagged one (single keyboard, older drivers)
+static int FindDawPort(int count, bool (*get_name)(int, char*, int), const SurfaceDevice& dev) {
+    const char* tag = dev.MidiPortTag();
+    int seen = 0, fallback = -1;
+    for (int i = 0; i < count; i++) {
         char name[256];
-        if (GetMIDIOutputName(i, name, sizeof(name))) {
-            if (strstr(name, "Komplete") && strstr(name, "DAW")) { outDev = i; break; }
-        }
+        if (!get_name(i, name, sizeof(name)) || !strstr(name, "Komplete") || !strstr(name, "DAW")) continue;
+        if (tag && strstr(name, tag)) {
+            if (seen++ == dev.ordinal) return i;
+        } else if (fallback < 0) fallback = i;
     }
+    return (seen == 0) ? fallback : -1;
+}
+
+void AutoDetectSoundFirstPorts(int& inDev, int& outDev, const SurfaceDevice& dev) {
+    inDev = FindDawPort(GetNumMIDIInputs(), GetMIDIInputName, dev);
+    outDev = FindDawPort(GetNumMIDIOutputs(), GetMIDIOutputName, dev);
 }
 
 // --- CLASS IMPLEMENTATION ---
 
-CSurf_SoundFirst::CSurf_SoundFirst(int inDev, int outDev, int outDev2) {
+CSurf_SoundFirst::CSurf_SoundFirst(int inDev, int outDev, int outDev2, DeviceRegistry* devices, const SurfaceDevice& device,
+                                   ConfigWatcher* config) {
+#ifdef _WIN32
     ::CoInitialize(NULL);
+#endif
     LogDebug("--- CONSTRUCTOR INICIADO (SoundFirst PRO) ---");
     
     m_midi_in_dev = inDev;
     m_midi_out_dev = outDev;
+
+    // Claimed here, on the UI thread, so instances created together never race for a keyboard
+    m_devices = devices;
+    m_device = device;
+    if (m_devices && m_device.pid != 0 && !m_devices->Claim(this, m_device)) {
+        SF_LOG(LOG_WARN, LOGCAT_HID, "Keyboard %s already owned by another surface", m_device.Label());
+    }
+    SF_LOG(LOG_INFO, LOGCAT_HID, "Surface for keyboard %s", m_device.Label());
     
     // Config path setup
-    const char* rPath = GetResourcePath();
-    if (rPath) {
-        char iniPath[1024]; sprintf(iniPath, "%s\\UserPlugins\\SoundFirst_PRO.ini", rPath);
-        m_config_path = iniPath;
-        LogDebug("Detectando archivo INI...");
-    }
+    m_config_watcher = config;
+    m_config_path = ConfigPath();
 
     LogDebug("Buscando puertos MIDI Komplete DAW...");
     int detIn = -1, detOut = -1;
-    AutoDetectSoundFirstPorts(detIn, detOut);
+    AutoDetectSoundFirstPorts(detIn, detOut, m_device);
     if (detIn != -1) { m_midi_in_dev = detIn; LogDebug("MIDI In detectado automáticamente."); }
     else LogDebug("MIDI In NO encontrado - Usando puerto por defecto.");
 
@@ -96,7 +95,7 @@ CSurf_SoundFirst::CSurf_SoundFirst(int inDev, int outDev, int outDev2) {
         unsigned char sysex[] = { 0xF0, 0x00, 0x21, 0x09, 0x00, 0x00, 0x44, 0x43, 0x01, 0x00, 0x07, 0x07, 0x00, 0x52, 0x65, 0x61, 0x70, 0x65, 0x72, 0xF7 };
         SendSysex(sysex, sizeof(sysex));
         LogDebug("Handshake MIDI enviado al teclado.");
-    } else LogDebug("ERROR: Fallo al crear MIDI Output.");
+    } else Logger::Instance().Write(LOG_ERROR, "ERROR: Fallo al crear MIDI Output.");
 
     m_current_bank = 0;
     m_current_mode = MODE_MIXER;
@@ -111,12 +110,28 @@ CSurf_SoundFirst::CSurf_SoundFirst(int inDev, int outDev, int outDev2) {
     m_gr_peak_hold = 0.0;
     m_last_gr_peak_time = 0;
     m_loop_button_state = 0;
+    m_ref_solo_active = false;
+    m_osara_output = nullptr;
+    m_config_string[0] = 0;
     m_grid_index = 4;
+
+    // Host notifications: force a full refresh on the first Run() tick
+    m_dirty = DIRTY_ALL;
+    m_focused_fx_track = nullptr;
+    m_focused_fx_index = -1;
     
     // Display V1.0 Init
     m_screensaver_active = false;
     m_last_input_time = 0; // Will be set in Run()
     m_gr_meter_mode = false; // Default to Peak
+    m_gr_clock.rate_hz = 15.0;
+    m_gr_meter.attack_ms = 0.0;            // GR needles jump to the reduction...
+    m_gr_meter.hold_ms = 300.0;
+    m_gr_meter.release_db_per_sec = 12.0;  // ...and recover slowly
+    m_gr_range_db = 20.0;
+    m_bank_tracks_bank = -1;
+    for (int i = 0; i < 8; i++) m_bank_tracks[i] = nullptr;
+    m_tick_report_time = 0.0;
     
     // Accessibility defaults
     m_announce_buttons = true;
@@ -125,6 +140,20 @@ CSurf_SoundFirst::CSurf_SoundFirst(int inDev, int outDev, int outDev2) {
     m_announce_actions = false;
     m_touch_auto_solo = false;
     
+    // Gesture undo defaults
+    m_gesture_open = false;
+    m_gesture_undo_flags = 0;
+    m_gesture_desc = "";
+    m_gesture_knobs = 0;
+    m_gesture_pan = 0;
+    m_gesture_last_move = 0;
+    m_gesture_timeout = 0.5; // Untouched turns: close after 500 ms idle
+
+    // Gang mode defaults
+    m_gang_mode = false;
+    m_gang_vol_db = 0.0;
+    m_gang_pan = 0.0;
+
     // Initialize touch state arrays
     for (int i = 0; i < 8; i++) {
         m_knob_touch_state[i] = false;
@@ -142,8 +171,8 @@ CSurf_SoundFirst::CSurf_SoundFirst(int inDev, int outDev, int outDev2) {
     m_current_fx_page = 0;
     m_current_fx_plugin = "";
     
-    LoadMappingConfig();
-    LoadMappingConfig();
+    ConfigPtr initial = m_config_watcher ? m_config_watcher->Snapshot() : nullptr;
+    ApplyConfig(initial ? initial : ParseConfig(m_config_path));
     
     // FORCE MODE RESET (V1.0 Standard)
     // Ignore whatever the INI file said.
@@ -155,108 +184,197 @@ CSurf_SoundFirst::CSurf_SoundFirst(int inDev, int outDev, int outDev2) {
     m_hid_thread = std::thread(&CSurf_SoundFirst::HidThreadLoop, this);
     LogDebug("Hilo de escucha HID de baja latencia arrancado.");
 
-    // Hot-reload setup
-    if (!m_config_path.empty()) {
-        WIN32_FILE_ATTRIBUTE_DATA data;
-        if (GetFileAttributesExA(m_config_path.c_str(), GetFileExInfoStandard, &data)) {
-            m_last_config_time = ((WDL_UINT64)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
-        }
-    }
     LogDebug("--- CONSTRUCTOR FINALIZADO CON ÉXITO ---");
 }
 
 CSurf_SoundFirst::~CSurf_SoundFirst() {
+    EndKnobGesture(); // Record a gesture still waiting for release
     m_hid_running = false;
     if (m_hid_thread.joinable()) m_hid_thread.join();
+    if (m_devices) m_devices->Release(this);
+#ifdef _WIN32
     if (m_hid_handle != INVALID_HANDLE_VALUE) CloseHandle(m_hid_handle);
+#endif
     // MIDI Input removido
     if (m_midi_out) delete m_midi_out;
+#ifdef _WIN32
     ::CoUninitialize();
+#endif
 }
 
 void CSurf_SoundFirst::CloseNoReset() { if (m_midi_out) { delete m_midi_out; m_midi_out = nullptr; } }
 
 const char* CSurf_SoundFirst::GetConfigString() {
-    static char cfg[512]; sprintf(cfg, "%d %d", m_midi_in_dev, m_midi_out_dev);
-    return cfg;
+    snprintf(m_config_string, sizeof(m_config_string), "%d %d", m_midi_in_dev, m_midi_out_dev);
+    return m_config_string;
 }
 
 
 int CSurf_SoundFirst::Extended(int call, void *parm1, void *parm2, void *parm3) { 
-    // TODO: Re-enable auto bank switching with correct REAPER constant
-    // Handle track selection changes for auto bank switching
-    // if (call == CSURF_EXT_SETTRACKLISTCHANGE) {
-        UpdateBankFromSelectedTrack();
-    // }
+    // Decode only. REAPER calls this for every automation-driven FX parameter
+    // change, so no API getters here: just raise dirty flags for Run().
+    switch (call) {
+        case CSURF_EXT_RESET:
+            m_dirty |= DIRTY_ALL;
+            break;
+        case CSURF_EXT_SETLASTTOUCHEDTRACK:
+            m_dirty |= DIRTY_SELECTION;
+            break;
+        case CSURF_EXT_SETFXCHANGE:
+            m_dirty |= DIRTY_FX_CHAIN;
+            break;
+        case CSURF_EXT_SETFOCUSEDFX:
+            m_focused_fx_track = (MediaTrack*)parm1;
+            m_focused_fx_index = parm3 ? *(int*)parm3 : -1;
+            m_dirty |= DIRTY_FOCUSED_FX;
+            break;
+        default:
+            // CSURF_EXT_SETFXPARAM, CSURF_EXT_SETLASTTOUCHEDFX & co: high frequency, nothing to recompute
+            break;
+    }
     return (call == 0x00010000) ? 1 : 0; 
 }
 
+void CSurf_SoundFirst::SetTrackListChange() { m_dirty |= DIRTY_TRACKLIST; }
+void CSurf_SoundFirst::SetSurfaceSelected(MediaTrack* t, bool s) { m_dirty |= DIRTY_SELECTION; }
+void CSurf_SoundFirst::OnTrackSelection(MediaTrack* t) { m_dirty |= DIRTY_SELECTION; }
+
+// Automation Touch/Latch: a bank track is "touched" while its knob is held
+// or still moving inside an open gesture.
+bool CSurf_SoundFirst::GetTouchState(MediaTrack* t, int isPan) {
+    if (m_current_mode != MODE_MIXER || !t) return false;
+    for (int k = 0; k < 8; k++) {
+        bool active = m_knob_touch_state[k] || (m_gesture_open && (m_gesture_knobs & (1u << k)));
+        if (!active) continue;
+        if (GetTrack(NULL, (m_current_bank * 8) + k) != t) continue;
+        bool pan = (m_gesture_pan & (1u << k)) != 0;
+        if ((isPan == 1) == pan) return true;
+    }
+    return false;
+}
+
+// Runs the recomputation for host notifications collected since the last tick.
+// Each flag is handled at most once per Run(), no matter how many events arrived.
+void CSurf_SoundFirst::ProcessDirtyFlags() {
+    SF_API_SCOPE();
+    if (!m_dirty) return;
+    unsigned int dirty = m_dirty;
+    m_dirty = 0;
+
+    // Bank follows the selected track
+    if (dirty & DIRTY_TRACKLIST) m_track_nav.Invalidate();
+    if (dirty & (DIRTY_TRACKLIST | DIRTY_SELECTION)) {
+        UpdateBankFromSelectedTrack();
+        if (m_gang_mode) RefreshSelectedTracks();
+        m_display.Invalidate(DisplayModel::FIELD_TRACK_STATE | DisplayModel::FIELD_TRACK_LINE | DisplayModel::FIELD_VOLUME);
+        m_display.InvalidateSlots(1, 1);
+    }
+    if (dirty & (DIRTY_FX_CHAIN | DIRTY_FOCUSED_FX)) m_display.InvalidateSlots(1, 1);
+    if (dirty & (DIRTY_TRACKLIST | DIRTY_SELECTION | DIRTY_FX_CHAIN)) m_gr_sources.Invalidate();
+    if (dirty & DIRTY_TRACKLIST) m_bank_tracks_bank = -1;
+
+    MediaTrack* sel = nullptr;
+    if (dirty & (DIRTY_TRACKLIST | DIRTY_SELECTION | DIRTY_FX_CHAIN | DIRTY_FOCUSED_FX)) sel = GetSelectedTrack(NULL, 0);
+
+    // Keep the FX cursor inside the (possibly shorter) chain
+    if (dirty & (DIRTY_TRACKLIST | DIRTY_SELECTION | DIRTY_FX_CHAIN)) {
+        int count = sel ? TrackFX_GetCount(sel) : 0;
+        if (count > 0 && m_selected_fx_index >= count) {
+            m_selected_fx_index = count - 1;
+            m_fx_page = 0;
+        }
+    }
+
+    // FX Mode follows the plugin window the user focused on the selected track
+    // (input FX carry the 0x1000000 flag and are not addressable by the knobs)
+    if ((dirty & DIRTY_FOCUSED_FX) && m_current_mode == MODE_FX && sel && m_focused_fx_track == sel) {
+        if (m_focused_fx_index >= 0 && m_focused_fx_index < 0x1000000 && m_focused_fx_index != m_selected_fx_index) {
+            m_selected_fx_index = m_focused_fx_index;
+            m_fx_page = 0;
+        }
+    }
+}
+
 void CSurf_SoundFirst::OnMIDIEvent(MIDI_event_t* evt) {
     // MIDI Input ignorado (Usamos HID)
 }
 
 void CSurf_SoundFirst::Run() {
-    CheckConfigHotReload();
-    ProcessHidQueue();
+    SF_API_SCOPE();
+    m_tick_budget.BeginTick(time_precise());
+    RunPhase(TickBudget::PHASE_CONFIG, &CSurf_SoundFirst::CheckConfigHotReload);
+    RunPhase(TickBudget::PHASE_HOST, &CSurf_SoundFirst::ProcessDirtyFlags);
+    RunPhase(TickBudget::PHASE_INPUT, &CSurf_SoundFirst::ProcessInput);
     
     // --- DISPLAY LOOP ---
-    UpdateDisplay(); // Handles Screensaver logic & Text Sync
+    RunPhase(TickBudget::PHASE_DISPLAY, &CSurf_SoundFirst::UpdateDisplay); // Handles Screensaver logic & Text Sync
     
     // --- VU METER ENGINE (0x49) ---
-    // Only update if screen is active (save USB bandwidth)
-    if (!m_screensaver_active) {
-        MediaTrack* tr = GetSelectedTrack(0, 0);
-        if (tr) {
-            int meterVal = 0;
-            if (m_gr_meter_mode) {
-                 // TODO: GR Phase 2. For now, show inverted peak or 0
-                 // Ideal: Read specific GR param if mapped.
-                 meterVal = 0; 
-            } else {
-                 // PEAK MODE
-                 double peakL = Track_GetPeakInfo(tr, 0);
-                 double peakR = Track_GetPeakInfo(tr, 1);
-                 double maxPeak = (peakL > peakR) ? peakL : peakR;
-                 
-                 // Logarithmic Scaling for Meter
-                 if (maxPeak > 0.0001) {
-                     double db = 20.0 * log10(maxPeak);
-                     // Map -60dB (0) to +6dB (127)
-                     // Scale: 66dB range
-                     double norm = (db + 60.0);
-                     if (norm < 0) meterVal = 0;
-                     else {
-                         meterVal = (int)(norm * (127.0 / 66.0));
-                         if (meterVal > 127) meterVal = 127;
-                     }
-                 }
-            }
-            SendLCDValue(0x49, meterVal);
-        } else {
-            SendLCDValue(0x49, 0); // No track = 0
+    RunPhase(TickBudget::PHASE_METER, &CSurf_SoundFirst::UpdateMeter);
+
+    // --- SPEECH: one coalesced utterance per tick ---
+    RunPhase(TickBudget::PHASE_SPEECH, &CSurf_SoundFirst::FlushAnnouncements);
+
+    double now = time_precise();
+    m_tick_budget.EndTick(now);
+    ReportTickBudget(now);
+}
+
+// Timed phase of Run(). Once the tick has used up its budget (usually on input),
+// display, meter and speech are deferred to a later tick, each for a bounded
+// number of ticks (TickBudget max_defer); config, host and input always run.
+void CSurf_SoundFirst::RunPhase(int phase, void (CSurf_SoundFirst::*fn)()) {
+    if (!m_tick_budget.BeginPhase(phase, time_precise())) return;
+    (this->*fn)();
+    m_tick_budget.EndPhase(phase, time_precise());
+}
+
+void CSurf_SoundFirst::ProcessInput() {
+    ProcessHidQueue();
+    CheckKnobGestureTimeout();
+    CheckKnobValueRelease();
+}
+
+// Every 10 s: over-budget ticks at INFO (the surface took time from REAPER's
+// UI), per-phase averages at DEBUG. Counters restart after each report.
+void CSurf_SoundFirst::ReportTickBudget(double now) {
+    if (m_tick_report_time == 0.0) m_tick_report_time = now;
+    if (now - m_tick_report_time < 10.0) return;
+    m_tick_report_time = now;
+
+    TickBudget& b = m_tick_budget;
+    if (b.over_budget > 0) {
+        SF_LOG(LOG_INFO, LOGCAT_GENERAL, "Run() over budget: %u of %u ticks (worst %.2f ms, budget %.2f ms)",
+               b.over_budget, b.ticks, b.worst_tick * 1000.0, b.budget * 1000.0);
+    }
+    if (SF_LOG_ON(LOG_DEBUG, LOGCAT_GENERAL)) {
+        for (int i = 0; i < TickBudget::NUM_PHASES; i++) {
+            const TickBudget::PhaseStats& p = b.phases[i];
+            SF_LOG(LOG_DEBUG, LOGCAT_GENERAL, "Run() phase %s: %u runs, avg %.3f ms, worst %.3f ms, %u deferred",
+                   TickBudget::PhaseName(i), p.runs, p.runs ? (p.total / p.runs) * 1000.0 : 0.0, p.worst * 1000.0, p.deferred);
         }
     }
+    b.ResetStats();
 }
 
+#ifdef _WIN32
 #include <setupapi.h>
 #include <initguid.h>
 #include <devguid.h>
 #include <hidsdi.h>
 
-// Helper to find the dynamic HID path for A61 (VID 17CC, PID 1620, Interface 3)
-// Helper to find the dynamic HID path (VID 17CC, PID 1750/1620)
-std::string GetA61HidPath() {
+// Every HID interface of a supported NI keyboard (VID 17CC), with its PID and serial number.
+// The registry groups interfaces per keyboard and prefers the DAW one (MI 02).
+void ScanSurfaceDevices(std::vector<SurfaceDevice>& out) {
+    out.clear();
     GUID hidGuid;
     HidD_GetHidGuid(&hidGuid);
     HDEVINFO hDevInfo = SetupDiGetClassDevsA(&hidGuid, NULL, NULL, DIGCF_PRESENT | DIGCF_DEVICEINTERFACE);
-    if (hDevInfo == INVALID_HANDLE_VALUE) return "";
+    if (hDevInfo == INVALID_HANDLE_VALUE) return;
 
     SP_DEVICE_INTERFACE_DATA deviceInterfaceData;
     deviceInterfaceData.cbSize = sizeof(SP_DEVICE_INTERFACE_DATA);
 
-    std::string bestMatch = "";
-    int ni_count = 0;
-
     for (DWORD i = 0; SetupDiEnumDeviceInterfaces(hDevInfo, NULL, &hidGuid, i, &deviceInterfaceData); i++) {
         DWORD detailSize = 0;
         SetupDiGetDeviceInterfaceDetailA(hDevInfo, &deviceInterfaceData, NULL, 0, &detailSize, NULL);
@@ -269,60 +387,84 @@ std::string GetA61HidPath() {
             std::string path = pDetail->DevicePath;
             std::string matchPath = path;
             std::transform(matchPath.begin(), matchPath.end(), matchPath.begin(), ::tolower);
+            size_t pid_pos = matchPath.find("pid_");
             
-            if (matchPath.find("vid_17cc") != std::string::npos) {
-                ni_count++;
-                
+            if (matchPath.find("vid_17cc") != std::string::npos && pid_pos != std::string::npos) {
+                SurfaceDevice dev;
+                dev.pid = (int)strtol(matchPath.c_str() + pid_pos + 4, NULL, 16);
+                dev.hid_path = path;
+
                 // Log all NI devices for diagnostics
-                char lMsg[512]; sprintf(lMsg, "[HID_SCAN] Found NI Device: %s", path.c_str());
-                RawLog(lMsg);
-                
-                // Prioritize user's actual hardware: PID 1750 (A-Series) OR PID 1860 (M32) OR 1620 (Legacy?) OR 1740 (A49)
-                // Both use the same protocol (MI 02 for DAW control usually)
-                if (matchPath.find("pid_1750") != std::string::npos || 
-                    matchPath.find("pid_1860") != std::string::npos || 
-                    matchPath.find("pid_1740") != std::string::npos || 
-                    matchPath.find("pid_1620") != std::string::npos) {
-                    // Check for Interface 2 (DAW) or Interface 1/3 depending on model. 
-                    // We look for "mi_02" or just accept the first valid PID match if strict MI check fails.
-                    if (matchPath.find("mi_02") != std::string::npos) {
-                        bestMatch = path;
-                        free(pDetail);
-                        // Stop at first good match to avoid ambiguity
-                        break; 
+                SF_LOG(LOG_DEBUG, LOGCAT_HID, "[HID_SCAN] Found NI Device: %s", path);
+
+                if (SurfaceDevice::Supported(dev.pid)) {
+                    // Serial number: query-only handle (no read/write access needed)
+                    HANDLE h = CreateFileA(path.c_str(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, NULL);
+                    if (h != INVALID_HANDLE_VALUE) {
+                        wchar_t wserial[128] = { 0 };
+                        if (HidD_GetSerialNumberString(h, wserial, sizeof(wserial))) {
+                            char serial[128] = { 0 };
+                            WideCharToMultiByte(CP_UTF8, 0, wserial, -1, serial, sizeof(serial), NULL, NULL);
+                            dev.serial = serial;
+                        }
+                        CloseHandle(h);
                     }
-                    // Fallback: If we see the PID but not "mi_02" (maybe mi_01?), keep it as candidate
-                    if (bestMatch.empty()) bestMatch = path;
+                    out.push_back(dev);
                 }
             }
         }
         free(pDetail);
     }
     SetupDiDestroyDeviceInfoList(hDevInfo);
-    return bestMatch;
+}
+#else
+void ScanSurfaceDevices(std::vector<SurfaceDevice>& out) { out.clear(); }
+#endif
+
+// Rescans, then resolves this surface's keyboard through the registry (claiming the
+// first free one if it has none yet). Without a registry: the first keyboard found.
+std::string CSurf_SoundFirst::FindHidPath() {
+    std::vector<SurfaceDevice> found;
+    ScanSurfaceDevices(found);
+    if (!m_devices) {
+        DeviceRegistry local;
+        local.Update(found);
+        std::vector<SurfaceDevice> devices = local.Devices();
+        return devices.empty() ? std::string() : devices[0].hid_path;
+    }
+    m_devices->Update(found);
+    SurfaceDevice dev = m_device;
+    if (!m_devices->Claim(this, dev)) return "";
+    if (!dev.SameDevice(m_device)) SF_LOG(LOG_INFO, LOGCAT_HID, "Surface claimed keyboard %s", dev.Label());
+    m_device = dev;
+    return dev.hid_path;
 }
 
 void CSurf_SoundFirst::HidThreadLoop() {
+#ifndef _WIN32
+    // No HID transport off Windows: reports arrive through InjectHidReport()
+    return;
+#else
     LogDebug("Hilo HID iniciado.");
     int attempts = 0;
     while (m_hid_running) {
         if (m_hid_handle == INVALID_HANDLE_VALUE) {
-            std::string path = GetA61HidPath();
+            std::string path = FindHidPath();
             if (!path.empty()) {
-                LogDebug((std::string("Ruta HID encontrada: ") + path).c_str());
+                SF_LOG(LOG_INFO, LOGCAT_HID, "Ruta HID encontrada (%s): %s", m_device.Label(), path);
                 m_hid_handle = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 
                     FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, 0, NULL);
                 if (m_hid_handle != INVALID_HANDLE_VALUE) {
-                    LogDebug("Conexión HID establecida con éxito.");
+                    SF_LOG(LOG_INFO, LOGCAT_HID, "Conexión HID establecida con éxito.");
                     std::this_thread::sleep_for(std::chrono::milliseconds(800));
                     // REMOVED UNSAFE SpeakText FROM BACKGROUND THREAD
                     // SpeakText("Conectado"); 
                     attempts = 0;
                 } else {
-                    LogDebug("ERROR: No se pudo abrir el handle HID (CreateFileA falló).");
+                    SF_LOG(LOG_ERROR, LOGCAT_HID, "ERROR: No se pudo abrir el handle HID (CreateFileA falló).");
                 }
             } else {
-                if (attempts % 10 == 0) LogDebug("Buscando dispositivo HID...");
+                if (attempts % 10 == 0) SF_LOG(LOG_DEBUG, LOGCAT_HID, "Buscando dispositivo HID...");
             }
             
             if (m_hid_handle == INVALID_HANDLE_VALUE) {
@@ -337,29 +479,45 @@ void CSurf_SoundFirst::HidThreadLoop() {
         // Request 64 bytes (Maximum Report Size). A-Series sends 30, M32 sends ~38. 
         // ReadFile will return what is available if we request enough.
         if (ReadFile(m_hid_handle, buf, 64, &read, NULL) && read > 0) {
-            std::lock_guard<std::mutex> lock(m_hid_mutex);
-            // Ensure we don't overflow internal fixed buffer (64)
-            if (read > 64) read = 64; 
-            
-            HidEvent ev; 
-            memset(ev.data, 0, 64);
-            memcpy(ev.data, buf, read);
-            m_hid_queue.push(ev);
-        } else { CloseHandle(m_hid_handle); m_hid_handle = INVALID_HANDLE_VALUE; }
+            // Decode here, off the UI thread; Run() only applies the frames
+            HidFrame frame;
+            m_hid_decoder.Decode(buf, frame);
+            m_hid_frames.Push(frame);
+        } else { CloseHandle(m_hid_handle); m_hid_handle = INVALID_HANDLE_VALUE; m_hid_decoder.Reset(); }
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
+#endif
 }
 
+// Same path as a report read by the HID thread. For hosts without a device
+// (bench/fake_host): never call it while a live HID thread owns the decoder.
+void CSurf_SoundFirst::InjectHidReport(const unsigned char* report, int len) {
+    unsigned char buf[64] = {0};
+    memcpy(buf, report, (len > 64) ? 64 : (len < 0 ? 0 : len));
+    HidFrame frame;
+    m_hid_decoder.Decode(buf, frame);
+    m_hid_frames.Push(frame);
+}
+
+// One drain per Run() tick. Knob and encoder handlers only add to their batches
+// (gang, notes, items, cursor, tracks); each Apply* below turns its batch into one
+// pass of REAPER calls, so API traffic follows the tick rate, not the report rate.
+// The batch structs themselves never call REAPER.
 void CSurf_SoundFirst::ProcessHidQueue() {
-    std::lock_guard<std::mutex> lock(m_hid_mutex);
-    while (!m_hid_queue.empty()) {
-        HandleHidReport(m_hid_queue.front().data);
-        m_hid_queue.pop();
-    }
+    SF_API_SCOPE();
+    m_hid_frames.Drain(m_hid_batch); // Lock held for the swap only: the HID thread never waits on REAPER
+    for (const HidFrame& f : m_hid_batch) HandleHidReport(f);
+    ApplyGangDeltas(); // One batched write per drain
+    ApplyNoteEdits();
+    ApplyItemEdits();
+    ApplyEncoderNav();
+    ApplyTrackNav();
 }
 
 bool CSurf_SoundFirst::RunNhlAction(const char* key) {
-    LogDebug((std::string("Action Hit: ") + key).c_str());
+    SF_API_SCOPE();
+    SF_LOG(LOG_DEBUG, LOGCAT_DISPATCH, "Action Hit: %s", key);
+    EndKnobGesture(); // The gesture's undo point comes before the action's
     
     // Announce button press if enabled
     if (m_announce_buttons) SpeakText(key);
@@ -373,18 +531,10 @@ bool CSurf_SoundFirst::RunNhlAction(const char* key) {
             // Checking dynamic mapping registry (User File or Factory)
             FXMapping* map = FXMappingRegistry::GetMapping(fxName);
             if (map) {
-                 int btn_id = -1;
-                 if (std::string(key) == "LOOP") btn_id = BTN_LOOP;
-                 else if (std::string(key) == "METRO") btn_id = BTN_METRO;
-                 else if (std::string(key) == "TEMPO") btn_id = BTN_TEMPO;
-                 else if (std::string(key) == "IDEAS") btn_id = BTN_IDEAS;
-                 else if (std::string(key) == "QUANTIZE") btn_id = BTN_QUANTIZE;
-                 else if (std::string(key) == "AUTO") btn_id = BTN_AUTO;
-                 else if (std::string(key) == "MUTE") btn_id = BTN_MUTE;
-                 else if (std::string(key) == "SOLO") btn_id = BTN_SOLO;
-                 // UNDO Removed by user request (Always Hardcoded Undo)
-
-                 if (btn_id != -1 && map->buttons.count(btn_id)) {
+                 int btn_id = MappableButtonFromKey(key);
+                 if (btn_id == BTN_UNDO) btn_id = -1; // UNDO Removed by user request (Always Hardcoded Undo)
+
+                 if (btn_id != -1 && map->buttons[btn_id]) {
                      std::string actionStr = map->buttons[btn_id];
                      
                      // 1. Is it a special action?
@@ -423,7 +573,7 @@ bool CSurf_SoundFirst::RunNhlAction(const char* key) {
                              if (m_announce_buttons) {
                                 char buf[256];
                                 TrackFX_GetFormattedParamValue(track, m_selected_fx_index, p_idx, buf, 256);
-                                SpeakText(buf);
+                                Announce(AnnouncementScheduler::ANNOUNCE_VALUE, buf);
                              }
                              return true; // Override successful
                          }
@@ -435,16 +585,19 @@ bool CSurf_SoundFirst::RunNhlAction(const char* key) {
 
     // 2. Read from INI config (mode-specific or global)
     std::string val = "";
-    if (m_shift_pressed) {
-        std::string sKey = std::string("SHIFT_") + key;
-        if (m_mode_actions[m_current_mode].count(sKey)) val = m_mode_actions[m_current_mode][sKey];
-        else if (m_nhl_actions.count(sKey)) val = m_nhl_actions[sKey];
-    }
-    
-    if (val.empty()) {
-        if (m_mode_actions[m_current_mode].count(key)) val = m_mode_actions[m_current_mode][key];
-        else if (m_nhl_actions.count(key)) val = m_nhl_actions[key];
-    }
+    const Config& cfg = *m_config;
+    auto lookup = [&](const std::string& k) -> bool {
+        auto mode_it = cfg.mode_actions.find(m_current_mode);
+        if (mode_it != cfg.mode_actions.end()) {
+            auto it = mode_it->second.find(k);
+            if (it != mode_it->second.end()) { val = it->second; return true; }
+        }
+        auto it = cfg.nhl_actions.find(k);
+        if (it != cfg.nhl_actions.end()) { val = it->second; return true; }
+        return false;
+    };
+    if (m_shift_pressed) lookup(std::string("SHIFT_") + key);
+    if (val.empty()) lookup(key);
 
     // If no config found, return false (not handled)
     if (val.empty()) return false;
@@ -457,19 +610,19 @@ bool CSurf_SoundFirst::RunNhlAction(const char* key) {
 
     if (val[0] == '@') {
         // Bank navigation
-        if (val == "@BANK_UP") { m_current_bank++; char m[64]; sprintf(m, "Bank %d", m_current_bank+1); SpeakText(m); }
-        else if (val == "@BANK_DOWN" && m_current_bank > 0) { m_current_bank--; char m[64]; sprintf(m, "Bank %d", m_current_bank+1); SpeakText(m); }
+        if (val == "@BANK_UP") { m_current_bank++; char m[64]; sprintf(m, "Bank %d", m_current_bank+1); Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, m); }
+        else if (val == "@BANK_DOWN" && m_current_bank > 0) { m_current_bank--; char m[64]; sprintf(m, "Bank %d", m_current_bank+1); Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, m); }
         
         // FX Page navigation
         else if (val == "@PAGE_UP") { 
             if (m_fx_page > 0) m_fx_page--; 
             char m[64]; sprintf(m, "Page %d", m_fx_page+1); 
-            SpeakText(m); 
+            Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, m); 
         }
         else if (val == "@PAGE_DOWN") { 
             m_fx_page++; 
             char m[64]; sprintf(m, "Page %d", m_fx_page+1); 
-            SpeakText(m); 
+            Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, m); 
         }
         
         // FX Bypass toggle
@@ -505,6 +658,8 @@ bool CSurf_SoundFirst::RunNhlAction(const char* key) {
             ReportTrackPeak();
         }
         else if (val == "@DUMP_FX") DumpCurrentFX();
+        else if (val == "@DUMP_API_TRACE") DumpApiTrace();
+        else if (val == "@GANG_TOGGLE") ToggleGangMode();
         else if (val == "@REPORT_STOP") { /* Stop reporting - handled by touch OFF */ }
         
         return true;
@@ -514,13 +669,13 @@ bool CSurf_SoundFirst::RunNhlAction(const char* key) {
     if (val[0] == '_') cmdId = NamedCommandLookup(val.c_str());
     else { try { cmdId = std::stoi(val); } catch (...) {} }
     if (cmdId > 0) {
-        Main_OnCommand(cmdId, 0);
-        
-        // Auto-update bank only after track navigation commands (MIXER mode)
-        // 40285=Track Down, 40286=Track Up
+        // Track navigation (40285=Track Down, 40286=Track Up) goes through the
+        // track cache: one selection change per drain, bank derived from the index
         if (cmdId == 40285 || cmdId == 40286) {
-            UpdateBankFromSelectedTrack();
+            m_track_nav.Add(cmdId == 40285 ? 1 : -1, false, time_precise());
+            return true;
         }
+        Main_OnCommand(cmdId, 0);
         return true;
     }
     return false;
@@ -528,6 +683,7 @@ bool CSurf_SoundFirst::RunNhlAction(const char* key) {
 
 // FX Parameter Manipulation Functions
 void CSurf_SoundFirst::HandleFxParamChange(const std::string& cmd, double delta) {
+    SF_API_SCOPE();
     // Parse command: @FX_PARAM_INC:fx_idx:param_idx or @FX_PARAM_DEC:fx_idx:param_idx
     size_t pos1 = cmd.find(':');
     if (pos1 == std::string::npos) return;
@@ -554,18 +710,15 @@ void CSurf_SoundFirst::HandleFxParamChange(const std::string& cmd, double delta)
         // Set new value
         TrackFX_SetParam(track, fx_idx, param_idx, new_val);
         
-        // Announce if knobs are announced
-        if (m_announce_knobs) {
-            char buf[256];
-            TrackFX_GetFormattedParamValue(track, fx_idx, param_idx, buf, 256);
-            SpeakText(buf);
-        }
+        // Announce if knobs are announced (throttled, final value after the presses stop)
+        NoteKnobValue(KnobValueAnnouncer::SOURCE_ACTION, KnobValueAnnouncer::TARGET_FX_PARAM, track, fx_idx, param_idx);
     } catch (...) {
-        LogDebug("Error parsing FX param change command");
+        SF_LOG(LOG_WARN, LOGCAT_DISPATCH, "Error parsing FX param change command: %s", cmd);
     }
 }
 
 void CSurf_SoundFirst::HandleFxParamSet(const std::string& cmd) {
+    SF_API_SCOPE();
     // Parse command: @FX_PARAM_SET:fx_idx:param_idx:value
     size_t pos1 = cmd.find(':');
     if (pos1 == std::string::npos) return;
@@ -587,19 +740,16 @@ void CSurf_SoundFirst::HandleFxParamSet(const std::string& cmd) {
         // Set parameter value (0.0 to 1.0)
         TrackFX_SetParam(track, fx_idx, param_idx, value);
         
-        // Announce if knobs are announced
-        if (m_announce_knobs) {
-            char buf[256];
-            TrackFX_GetFormattedParamValue(track, fx_idx, param_idx, buf, 256);
-            SpeakText(buf);
-        }
+        // Announce if knobs are announced (throttled, final value after the presses stop)
+        NoteKnobValue(KnobValueAnnouncer::SOURCE_ACTION, KnobValueAnnouncer::TARGET_FX_PARAM, track, fx_idx, param_idx);
     } catch (...) {
-        LogDebug("Error parsing FX param set command");
+        SF_LOG(LOG_WARN, LOGCAT_DISPATCH, "Error parsing FX param set command: %s", cmd);
     }
 }
 
 // Gain Reduction Reporting (mapeable per-FX)
 void CSurf_SoundFirst::HandleReportGR(const std::string& cmd) {
+    SF_API_SCOPE();
     // Parse command: @REPORT_GR:fx_idx OR :fx_idx
     int fx_idx = -1;
     size_t pos1 = cmd.find(':');
@@ -615,26 +765,16 @@ void CSurf_SoundFirst::HandleReportGR(const std::string& cmd) {
     MediaTrack* track = GetSelectedTrack(NULL, 0);
     if (!track) { SpeakText("No track selected"); return; }
     
-    // Read GainReduction_dB from FX
-    char buf[256] = {0};
-    // Try "GainReduction_dB" (VST3/CLAP standard)
-    bool success = TrackFX_GetNamedConfigParm(track, fx_idx, "GainReduction_dB", buf, 256);
-    
-    if (success && buf[0] != '\0') {
-        try {
-            double gr_db = std::stod(buf);
-            if (gr_db == 0.0) {
-                 SpeakText("No reduction");
-            } else {
-                 // GR is usually negative? Or positive reduction?
-                 // Some plugins report -3.0. A61 usually displays +3.0 reduction.
-                 // We'll read absolute value.
-                 int gr_int = (int)round(fabs(gr_db));
-                 char msg[64]; sprintf(msg, "Reduction %d dB", gr_int);
-                 SpeakText(msg);
-            }
-        } catch (...) {
-            SpeakText("GR Value Error");
+    // Same source probing as the GR meter (native GainReduction_dB or mapped meter param)
+    double gr_db = 0.0;
+    if (FindGrSource(track, fx_idx) == fx_idx && ReadGainReduction(track, fx_idx, &gr_db)) {
+        if (gr_db == 0.0) {
+             Announce(AnnouncementScheduler::ANNOUNCE_VALUE, "No reduction");
+        } else {
+             // A61 usually displays reduction as a positive amount
+             int gr_int = (int)round(gr_db);
+             char msg[64]; sprintf(msg, "Reduction %d dB", gr_int);
+             Announce(AnnouncementScheduler::ANNOUNCE_VALUE, msg);
         }
     } else {
         // Fallback: Check if it's a Waves plugin? They obscure GR.
@@ -644,6 +784,7 @@ void CSurf_SoundFirst::HandleReportGR(const std::string& cmd) {
 
 // Track Peak Reporting
 void CSurf_SoundFirst::ReportTrackPeak() {
+    SF_API_SCOPE();
     MediaTrack* track = GetLastTouchedTrack();
     if (!track) return;
     
@@ -666,21 +807,26 @@ void CSurf_SoundFirst::ReportTrackPeak() {
             sprintf(msg, "Peak %d dB", peak_int);
         }
         
-        SpeakText(msg);
+        Announce(AnnouncementScheduler::ANNOUNCE_VALUE, msg);
         LogDebug(msg);
     } else {
-        SpeakText("No signal");
+        Announce(AnnouncementScheduler::ANNOUNCE_VALUE, "No signal");
     }
 }
 
 // Auto-update bank when selected track changes (from v1.2 - event-driven, not polling)
 void CSurf_SoundFirst::UpdateBankFromSelectedTrack() {
+    SF_API_SCOPE();
     MediaTrack* track = GetSelectedTrack(NULL, 0);
-    if (!track) return;
-    
+    if (!track) { m_track_nav.current = -1; return; }
+    // Selected by ApplyTrackNav: bank already set from the index
+    if (m_track_nav.tracks_valid && m_track_nav.current >= 0 && m_track_nav.tracks[m_track_nav.current] == track) return;
+
     int trackNumber = (int)GetMediaTrackInfo_Value(track, "IP_TRACKNUMBER");
     int trackIndex = trackNumber - 1;
+    m_track_nav.current = -1;
     if (trackIndex < 0) return; // Master track or error
+    if (trackIndex < (int)m_track_nav.tracks.size() && m_track_nav.tracks[trackIndex] == track) m_track_nav.current = trackIndex;
 
     int new_bank = trackIndex / 8;
     
@@ -694,23 +840,32 @@ void CSurf_SoundFirst::UpdateBankFromSelectedTrack() {
                 m_current_bank * 8 + 8);
         
         LogDebug(msg);
-        SpeakText(msg);
+        Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, msg);
     }
 }
 
-void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
+// Applies one decoded frame (see HidDecoder): edges, deltas and fixed
+// commands are already computed, this only resolves and calls REAPER.
+void CSurf_SoundFirst::HandleHidReport(const HidFrame& f) {
+    SF_API_SCOPE();
     ResetIdleTimer(); // Activity detected
-    unsigned char* old = m_last_hid_report;
+    const unsigned char* data = f.data;
     
     // --- VERIFIED A61 (PID 1750) GROUND TRUTH ---
     bool isShift = (data[1] & 0x01); m_shift_pressed = isShift;
 
-    if (memcmp(data, old, 64) != 0) {
-        char hex[128]; char* p = hex;
-        for (int i = 0; i < 8; i++) p += sprintf(p, "%02X ", data[i]);
-        char fullMsg[256]; sprintf(fullMsg, "[A61_TRUTH] %s", hex);
-        RawLog(fullMsg);
+    // Buttons end a running knob gesture first and land queued cursor / track moves: both
+    // take effect before whatever the button does (UNDO/REDO included). Byte 4 bit 0 is
+    // ENC_DOWN; its other bits are touch.
+    bool buttons = f.num_commands > 0 || f.pressed[1] || f.pressed[2] || f.pressed[3] || (f.pressed[4] & 0x01);
+    if (buttons) {
+        EndKnobGesture();
+        ApplyEncoderNav();
+        ApplyTrackNav();
     }
+
+    // Fixed transport buttons (UNDO/REDO, PLAY, STOP, REC), resolved by the decoder
+    for (int i = 0; i < f.num_commands; i++) Main_OnCommand(f.commands[i], 0);
     
     // START CONTEXT FIX
     HWND midi_editor = NULL;
@@ -718,26 +873,22 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
 
     // Byte 1: SYSTEM (0x02) -> SCALE (Save Project)
     // Confirmed: 0x02 is Scale. Ideas is 0x20.
-    if ((data[1] & 0x02) && !(old[1] & 0x02)) { 
+    if ((f.pressed[1] & 0x02)) { 
         Main_OnCommand(40026, 0); // Save project
         SpeakText("Project Saved");
     }
     
     // ARP -> Report Peak
-    if ((data[1] & 0x04) && !(old[1] & 0x04)) ReportTrackPeak();
-    
-    // UNDO / REDO
-    if ((data[1] & 0x08) && !(old[1] & 0x08)) {
-        if (isShift) Main_OnCommand(40030, 0); // REDO
-        else Main_OnCommand(40029, 0);         // UNDO
-    }
+    if ((f.pressed[1] & 0x04)) ReportTrackPeak();
     
     // IDEAS (0x20) -> GR Toggle (Shift) / GR Report / Auto-Solo
-    if ((data[1] & 0x20) && !(old[1] & 0x20)) {
+    if ((f.pressed[1] & 0x20)) {
          if (RunNhlAction("IDEAS")) { /* Overridden */ }
          else if (isShift) {
              // Shift: Toggle Meter Mode (Peak <-> GR)
              m_gr_meter_mode = !m_gr_meter_mode;
+             m_gr_meter.Reset();
+             m_meter.Reset();
              if (m_gr_meter_mode) SpeakText("Meter: G R");
              else SpeakText("Meter: Peak");
              UpdateDisplay();
@@ -759,7 +910,7 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
     }
     
     // QUANTIZE -> Quantize Events (Mixer) / Quantize Events (MIDI) / Reverse (Audio)
-    if ((data[1] & 0x10) && !(old[1] & 0x10)) {
+    if ((f.pressed[1] & 0x10)) {
         if (RunNhlAction("QUANTIZE")) { /* Overridden */ }
         else if (m_current_mode == MODE_MIDI) {
              if (isShift) { /* Unmapped */ }
@@ -774,29 +925,28 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
         } else {
              // MIXER MODE: QUANTIZE BUTTON -> REFERENCE SOLO (TRACK 1)
              // Logic: Solo Track 1 exclusively. Second press = UNDO (Restore previous state).
-             static bool ref_solo_active = false;
-             if (!ref_solo_active) {
-                 Undo_BeginBlock2(0);
-                 Main_OnCommand(40340, 0); // Unsolo all tracks
+             if (!m_ref_solo_active) {
                  MediaTrack* t1 = GetTrack(0, 0);
                  if (t1) {
+                     Undo_BeginBlock2(0);
+                     Main_OnCommand(40340, 0); // Unsolo all tracks
                      SetMediaTrackInfo_Value(t1, "I_SOLO", 1); // Solo Track 1
                      Undo_EndBlock2(0, "Solo Reference", -1);
-                     ref_solo_active = true;
+                     m_ref_solo_active = true;
                      SpeakText("Reference Solo");
                  } else {
                      SpeakText("Track 1 not found");
                  }
              } else {
                  Main_OnCommand(40029, 0); // Undo (Restores previous solo state)
-                 ref_solo_active = false;
+                 m_ref_solo_active = false;
                  SpeakText("Restored");
              }
         }
     }
     
     // LOOP -> Loop Toggle (Mixer) / CUT (MIDI/AUDIO)
-    if ((data[1] & 0x40) && !(old[1] & 0x40)) { 
+    if ((f.pressed[1] & 0x40)) { 
         if (RunNhlAction("LOOP")) { /* Overridden */ }
         else if (m_current_mode == MODE_MIDI) {
              // User Request: Force 40012 (Cut)
@@ -818,7 +968,7 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
     }
     
     // METRO -> Metro Toggle (Mixer) / COPY (MIDI/AUDIO)
-    if ((data[1] & 0x80) && !(old[1] & 0x80)) {
+    if ((f.pressed[1] & 0x80)) {
         if (RunNhlAction("METRO")) { /* Overridden */ }
         else if (m_current_mode == MODE_MIDI) {
              // User Request: Force 40010 (Copy)
@@ -835,7 +985,7 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
 
     // Byte 2: TRANSPORT
     // TEMPO -> Tap Tempo (Mixer) / PASTE (MIDI/AUDIO)
-    if ((data[2] & 0x01) && !(old[2] & 0x01)) {
+    if ((f.pressed[2] & 0x01)) {
         if (RunNhlAction("TEMPO")) { /* Overridden */ }
         else if (m_current_mode == MODE_MIDI) {
              // User Request: Force 40011 (Paste)
@@ -850,27 +1000,14 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
         }
     }
 
-    if ((data[2] & 0x02) && !(old[2] & 0x02)) { // PLAY
-         if (isShift) {
-             // Consistency: Always Global Start (40042)
-             Main_OnCommand(40042, 0); 
-         }
-         else Main_OnCommand(40073, 0);         // Play/Pause
+    // Shift+REC: Cycle Automation (plain REC is a decoder command)
+    if ((f.pressed[2] & 0x04) && isShift) {
+        if (!RunNhlAction("AUTO")) Main_OnCommand(40406, 0); // Cycle Automation Mode
     }
     
-    // REC: Record (Normal) / Cycle Automation (Shift)
-    if ((data[2] & 0x04) && !(old[2] & 0x04)) {
-        if (isShift) {
-             if (!RunNhlAction("AUTO")) Main_OnCommand(40406, 0); // Cycle Automation Mode
-        }
-        else Main_OnCommand(1013, 0);          // Transport: Record
-    }
-
-    if ((data[2] & 0x08) && !(old[2] & 0x08)) Main_OnCommand(1016, 0); // STOP
-    
     // TRACK MANAGEMENT / EDIT ACTIONS
     // PRESET UP (0x10) -> FX Page Up / Arm Auto / Split
-    if ((data[2] & 0x10) && !(old[2] & 0x10)) {
+    if ((f.pressed[2] & 0x10)) {
         if (m_current_mode == MODE_FX) {
             // FX MODE: NEXT PAGE
             MediaTrack* t = GetSelectedTrack(NULL, 0);
@@ -879,15 +1016,15 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
             
             if (map && m_fx_page < map->pages.size() - 1) {
                 m_fx_page++;
-                char m[64]; sprintf(m, "FX Page %d: %s", m_fx_page+1, map->pages[m_fx_page].name.c_str());
-                SpeakText(m);
+                char m[64]; sprintf(m, "FX Page %d: %s", m_fx_page+1, map->pages[m_fx_page].name);
+                Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, m);
             } else if (!map) {
                  // Auto-Map Unlimited Pages (Groups of 8)
                  m_fx_page++;
                  char m[64]; sprintf(m, "Auto Page %d", m_fx_page+1);
-                 SpeakText(m);
+                 Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, m);
             } else {
-                 SpeakText("Last Page");
+                 Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, "Last Page");
             }
         } 
         else if (m_current_mode == MODE_AUDIO) {
@@ -903,7 +1040,7 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
     }
 
     // MUTE (0x40)
-    if ((data[2] & 0x40) && !(old[2] & 0x40)) {
+    if ((f.pressed[2] & 0x40)) {
         if (RunNhlAction("MUTE")) { /* Overridden */ }
         else {
              if (m_current_mode == MODE_FX) {
@@ -922,7 +1059,7 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
     }
 
     // SOLO (0x80)
-    if ((data[2] & 0x80) && !(old[2] & 0x80)) {
+    if ((f.pressed[2] & 0x80)) {
         if (RunNhlAction("SOLO")) { /* Overridden */ }
         else {
              // Default Solo Toggle (Track)
@@ -931,7 +1068,7 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
     }
 
     // PRESET DOWN (0x20) -> FX Page Down / Bypass / Delete
-    if ((data[2] & 0x20) && !(old[2] & 0x20)) {
+    if ((f.pressed[2] & 0x20)) {
         if (m_current_mode == MODE_FX) {
              // FX MODE: PREV PAGE
              if (m_fx_page > 0) {
@@ -943,9 +1080,9 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
                  std::string pName = (map && m_fx_page < map->pages.size()) ? map->pages[m_fx_page].name : "Auto";
                  
                  char m[64]; sprintf(m, "FX Page %d: %s", m_fx_page+1, pName.c_str());
-                 SpeakText(m);
+                 Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, m);
              } else {
-                 SpeakText("Page 1");
+                 Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, "Page 1");
              }
         }
         else if (m_current_mode == MODE_MIDI) {
@@ -964,20 +1101,14 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
 
     // Byte 3: 4D NAV / MODES
     
-    // DIAGNOSTIC LOGGING FOR BUTTONS (Byte 3)
-    if (data[3] != old[3]) {
-        char diag[64]; sprintf(diag, "Byte 3 Change: %02X (Was %02X)", data[3], old[3]);
-        RawLog(diag);
-    }
-    
     // BROWSER: Mode Selection
-    if ((data[3] & 0x01) && !(old[3] & 0x01)) {
+    if ((f.pressed[3] & 0x01)) {
         m_browser_mode_selection = true;
-        SpeakText(("Mode " + m_available_modes[m_current_mode_idx]).c_str());
+        Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, ("Mode " + m_available_modes[m_current_mode_idx]).c_str());
     }
     
     // PLUGIN: FX Mode Directly
-    if ((data[3] & 0x02) && !(old[3] & 0x02)) {
+    if ((f.pressed[3] & 0x02)) {
         m_browser_mode_selection = false;
         m_current_mode = MODE_FX;
         m_selected_fx_index = 0; 
@@ -988,29 +1119,27 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
         MediaTrack* t = GetSelectedTrack(NULL, 0);
         if (t) {
              char fxN[256]; TrackFX_GetFXName(t, m_selected_fx_index, fxN, 256);
-             SpeakText(fxN);
+             Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, fxN);
         }
     }
     
-    // TRACK: Mixer Mode Directly
-    if ((data[3] & 0x04) && !(old[3] & 0x04)) {
+    // TRACK: Mixer Mode Directly (Shift: Gang selected tracks)
+    if ((f.pressed[3] & 0x04)) {
         m_browser_mode_selection = false;
         m_current_mode = MODE_MIXER;
-        SpeakText("MIXER Mode");
+        if (isShift) ToggleGangMode();
+        else SpeakText("MIXER Mode");
     }
     
-    // ENCODER NAVIGATION (Hardcoded)
-    // ENCODER NAVIGATION (Hardcoded)
-    if ((data[3] & 0x20) && !(old[3] & 0x20)) {
-        Main_OnCommand(40286, 0); // ENC_UP -> Prev Track
-        UpdateBankFromSelectedTrack();
+    // ENCODER NAVIGATION (Hardcoded; applied once per drain by ApplyTrackNav)
+    if ((f.pressed[3] & 0x20)) {
+        m_track_nav.Add(-1, isShift, time_precise()); // ENC_UP -> Prev Track (Shift: prev bank)
     }
-    if ((data[3] & 0x01) == 0 && (data[4] & 0x01) && !(old[4] & 0x01)) {
-        Main_OnCommand(40285, 0); // ENC_DOWN -> Next Track
-        UpdateBankFromSelectedTrack();
+    if ((data[3] & 0x01) == 0 && (f.pressed[4] & 0x01)) {
+        m_track_nav.Add(1, isShift, time_precise());  // ENC_DOWN -> Next Track (Shift: next bank)
     }
 
-    if ((data[3] & 0x40) && !(old[3] & 0x40)) { // ENC_LEFT
+    if ((f.pressed[3] & 0x40)) { // ENC_LEFT
          if (m_current_mode == MODE_FX) {
              // FX: Prev Plugin
              if (m_selected_fx_index > 0) {
@@ -1024,18 +1153,18 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
                  TrackFX_Show(t, m_selected_fx_index, 1); 
                  
                  char fxN[256]; TrackFX_GetFXName(t, m_selected_fx_index, fxN, 256);
-                 SpeakText(fxN);
+                 Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, fxN);
              }
          } else if (m_current_mode == MODE_AUDIO || m_current_mode == MODE_MIDI) {
              Main_OnCommand(40416, 0); // Select prev item
          } else {
              // Global: Prev Marker
              Main_OnCommand(40172, 0); 
-             SpeakText("Prev Marker");
+             Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, "Prev Marker");
          }
     }
     
-    if ((data[3] & 0x80) && !(old[3] & 0x80)) { // ENC_RIGHT
+    if ((f.pressed[3] & 0x80)) { // ENC_RIGHT
          if (m_current_mode == MODE_FX) {
              // FX: Next Plugin
              MediaTrack* t = GetSelectedTrack(NULL, 0);
@@ -1050,19 +1179,19 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
                  TrackFX_Show(t, m_selected_fx_index, 1);
                  
                  char fxN[256]; TrackFX_GetFXName(t, m_selected_fx_index, fxN, 256);
-                 SpeakText(fxN);
+                 Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, fxN);
              }
          } else if (m_current_mode == MODE_AUDIO || m_current_mode == MODE_MIDI) {
              Main_OnCommand(40417, 0); // Select next item
          } else {
              // Global: Next Marker
              Main_OnCommand(40173, 0); 
-             SpeakText("Next Marker");
+             Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, "Next Marker");
          }
     }
 
     // Encoder Click
-    if ((data[5] & 0x02) && !(old[5] & 0x02)) {
+    if ((f.pressed[5] & 0x02)) {
         if (m_browser_mode_selection) {
             // Confirm Mode
             m_browser_mode_selection = false;
@@ -1120,7 +1249,8 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
     // (Preserve Mixer Auto-Solo Logic)
     for (int k = 0; k < 7; k++) {
         bool current_touch = (data[4] & (1 << (k+1))) != 0;
-        bool previous_touch = (old[4] & (1 << (k+1))) != 0;
+        bool previous_touch = (f.Previous(4) & (1 << (k+1))) != 0;
+        m_knob_touch_state[k] = current_touch;
         
         if (current_touch != previous_touch) {
              // In Mixer Mode: Auto Solo Logic
@@ -1148,7 +1278,8 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
     // Touch K8 (separate logic in packet)
     {
         bool current_touch = (data[5] & 0x01) != 0;
-        bool previous_touch = (old[5] & 0x01) != 0;
+        bool previous_touch = (f.Previous(5) & 0x01) != 0;
+        m_knob_touch_state[7] = current_touch;
         if (current_touch != previous_touch) {
              if (m_current_mode == MODE_MIXER && m_touch_auto_solo) {
                  int track_idx = (m_current_bank * 8) + 7;
@@ -1167,31 +1298,40 @@ void CSurf_SoundFirst::HandleHidReport(unsigned char* data) {
         }
     }
 
-    // Byte 28: Encoder Turn (Continuous Counter)
-    if (data[28] != old[28]) {
-        int delta = (int)((signed char)data[28] - (signed char)old[28]);
-        if (delta > 128) delta -= 256;
-        else if (delta < -128) delta += 256;
-        if (delta != 0) HandleEncoderRotation(delta);
-    }
+    // Byte 28: Encoder Turn (summed over the merged reports)
+    if (f.encoder_delta != 0) HandleEncoderRotation(f.encoder_delta);
 
-    // Bytes 6-21: Knobs
+    // Bytes 6-21: Knobs (already accelerated; the curve depends on the mode)
+    const int* knob_delta = (m_current_mode == MODE_FX) ? f.knob_delta_fx : f.knob_delta;
     for (int i = 0; i < 8; i++) {
-        int b = 6 + (i * 2);
-        int val = data[b] | (data[b+1] << 8);
-        if (m_last_knob_values[i] != -1 && val != m_last_knob_values[i]) {
-            int d = val - m_last_knob_values[i];
-            if (d > 512) d -= 1024; else if (d < -512) d += 1024;
-            if (abs(d) < 200) HandleKnobRotation(i, d);
+        if (knob_delta[i] != 0) HandleKnobRotation(i, knob_delta[i]);
+    }
+
+    // Gesture end: last finger released -> close the undo block
+    if (m_gesture_open) {
+        bool any_touch = false;
+        for (int k = 0; k < 8; k++) if (m_knob_touch_state[k]) { any_touch = true; break; }
+        bool was_touched = (f.Previous(4) & 0xFE) || (f.Previous(5) & 0x01);
+        if (!any_touch && was_touched) EndKnobGesture();
+    }
+
+    // Value announcer: exact final value of each knob released in this report
+    if (m_announce_knobs) {
+        unsigned int released = 0;
+        for (int k = 0; k < 7; k++) if (f.released[4] & (1 << (k+1))) released |= (1u << k);
+        if (f.released[5] & 0x01) released |= 0x80;
+        if (released) {
+            ApplyGangDeltas(); // Gang writes normally land after the drain
+            for (int k = 0; k < 8; k++) {
+                if ((released & (1u << k)) && m_value_announcer.Released(k)) SpeakKnobValue(k);
+            }
         }
-        m_last_knob_values[i] = val;
     }
-
-    memcpy(m_last_hid_report, data, 64);
 }
 
 
 void CSurf_SoundFirst::HandleEncoderRotation(int delta) {
+    SF_API_SCOPE();
     if (delta == 0) return;
     ResetIdleTimer();
     
@@ -1206,16 +1346,15 @@ void CSurf_SoundFirst::HandleEncoderRotation(int delta) {
         }
         
         // Announce mode
-        SpeakText(("Mode " + m_available_modes[m_current_mode_idx]).c_str());
+        Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, ("Mode " + m_available_modes[m_current_mode_idx]).c_str());
     } else {
         // NORMAL MODE: Hardcoded Actions
         if (m_shift_pressed) {
             
             // --- MIXER MODE SHIFT LOGIC (User Request) ---
             if (m_current_mode == MODE_MIXER) {
-                 // Shift + Rotate = Move Loop Points (40632/40633)
-                 if (delta > 0) Main_OnCommand(40632, 0); // Loop Right
-                 else Main_OnCommand(40633, 0);           // Loop Left
+                 // Shift + Rotate = Move Loop Points (whole drain, see ApplyEncoderNav)
+                 m_encoder_nav.Add(delta, EncoderNav::TARGET_LOOP);
                  return;
             }
             
@@ -1223,40 +1362,67 @@ void CSurf_SoundFirst::HandleEncoderRotation(int delta) {
             if (delta > 0) Main_OnCommand(NamedCommandLookup("_OSARA_NEXTTRANSIENT"), 0);
             else Main_OnCommand(NamedCommandLookup("_OSARA_PREVTRANSIENT"), 0);
         } else {
-            // NORMAL: Move Edit Cursor (One Beat)
-            if (delta > 0) Main_OnCommand(41044, 0); // Move edit cursor forward one beat
-            else Main_OnCommand(41045, 0);           // Move edit cursor back one beat
+            // NORMAL: Move Edit Cursor (beats; bars / sections when spun fast)
+            m_encoder_nav.Add(delta, EncoderNav::TARGET_CURSOR);
         }
     }
 }
 
-// Dispatcher with Adaptive Acceleration
-void CSurf_SoundFirst::HandleKnobRotation(int idx, int d) {
-    if (d == 0) return;
-    ResetIdleTimer();
+// Slow turns step beats, faster spins bars, then sections (BarsPerSection bars),
+// resolved on the tempo map.
+void CSurf_SoundFirst::ApplyEncoderNav() {
+    SF_API_SCOPE();
+    EncoderNav& nav = m_encoder_nav;
+    if (nav.pending == 0) return;
+    int steps = nav.pending;
+    int unit = nav.TakeUnit(time_precise());
+
+    double loop_start = 0.0, loop_end = 0.0, from;
+    if (nav.target == EncoderNav::TARGET_LOOP) {
+        GetSet_LoopTimeRange(false, true, &loop_start, &loop_end, false);
+        if (loop_end <= loop_start) { Announce(AnnouncementScheduler::ANNOUNCE_STATUS, "No loop"); return; }
+        from = loop_start;
+    } else {
+        from = GetCursorPosition();
+    }
 
-    // ADAPTIVE ACCELERATION (V1.0)
-    // Formula: d_final = d * (1 + (abs(d) / 4))
-    // Small turns (d=1,2,3) -> Stay 1, 2, 3 (Precision)
-    // Medium turns (d=4,5) -> Becomes 8, 11 (Boost)
-    // Fast turns (d=10) -> Becomes 35 (Turbo)
-    
-    int ad = abs(d);
-    int accel_d = d;
-    
-    // Split Acceleration Profiles
-    if (m_current_mode == MODE_FX) {
-        // GENTLER curve for FX (Parameters 0.0-1.0 are sensitive)
-        if (ad > 4) {
-             accel_d = d * (1 + (ad / 8)); 
-        }
+    int measure = 0, beats_in_bar = 4;
+    double full_beats = 0.0;
+    double beat = TimeMap2_timeToBeats(NULL, from, &measure, &beats_in_bar, &full_beats, NULL);
+    double to;
+    if (unit == EncoderNav::UNIT_BEAT) {
+        to = TimeMap2_beatsToTime(NULL, EncoderNav::Step(full_beats, 1, steps), NULL);
     } else {
-        // AGGRESSIVE curve for Mixer/MIDI (Faders need travel)
-        if (ad > 3) {
-             accel_d = d * (1 + (ad / 4));
-        }
+        double bar_pos = measure + ((beats_in_bar > 0) ? beat / beats_in_bar : 0.0);
+        int size = (unit == EncoderNav::UNIT_SECTION) ? nav.bars_per_section : 1;
+        int to_measure = (int)EncoderNav::Step(bar_pos, size, steps);
+        to = TimeMap2_beatsToTime(NULL, 0.0, &to_measure);
+    }
+    if (to < 0.0) to = 0.0;
+
+    if (nav.target == EncoderNav::TARGET_LOOP) {
+        double shift = to - loop_start;
+        loop_start += shift;
+        loop_end += shift;
+        GetSet_LoopTimeRange(true, true, &loop_start, &loop_end, false);
+    } else {
+        SetEditCurPos(to, true, true);
     }
-    
+
+    if (m_announce_encoder) {
+        char pos[64];
+        format_timestr_pos(to, pos, sizeof(pos), 2); // Measures.beats
+        Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, pos);
+    }
+}
+
+// Dispatcher. accel_d arrives accelerated from HidDecoder (AccelerateKnob).
+void CSurf_SoundFirst::HandleKnobRotation(int idx, int accel_d) {
+    if (accel_d == 0) return;
+    ResetIdleTimer();
+
+    // Handlers call BeginKnobGesture once they have changed something: the whole
+    // gesture becomes one undo point
     if (m_current_mode == MODE_MIXER) HandleKnob_Mixer(idx, accel_d);
     else if (m_current_mode == MODE_MIDI) HandleKnob_MIDI(idx, accel_d);
     else if (m_current_mode == MODE_AUDIO) HandleKnob_Audio(idx, accel_d);
@@ -1265,26 +1431,94 @@ void CSurf_SoundFirst::HandleKnobRotation(int idx, int d) {
 
 
 void CSurf_SoundFirst::HandleKnob_Mixer(int idx, int d) {
+    SF_API_SCOPE();
     bool sh = m_shift_pressed;
     MediaTrack* t = GetTrack(NULL, (m_current_bank * 8) + idx);
     if (!t) return;
 
+    // GANG: accumulate relative delta, written to all selected tracks after the drain
+    if (m_gang_mode && std::find(m_selected_tracks.begin(), m_selected_tracks.end(), t) != m_selected_tracks.end()) {
+        if (sh) m_gang_pan += (d * m_knob_sensitivity);
+        else m_gang_vol_db += (d * m_knob_sensitivity * 2.0);
+        BeginKnobGesture(idx, UNDO_STATE_TRACKCFG, sh ? "SoundFirst: Adjust track pan" : "SoundFirst: Adjust track volume", sh);
+        NoteKnobValue(idx, sh ? KnobValueAnnouncer::TARGET_TRACK_PAN : KnobValueAnnouncer::TARGET_TRACK_VOLUME, t);
+        return;
+    }
+
     if (sh) {
         // PAN
         double vol = GetMediaTrackInfo_Value(t, "D_PAN");
         vol += (d * m_knob_sensitivity);
         if (vol < -1.0) vol = -1.0; else if (vol > 1.0) vol = 1.0;
         SetMediaTrackInfo_Value(t, "D_PAN", vol);
+        BeginKnobGesture(idx, UNDO_STATE_TRACKCFG, "SoundFirst: Adjust track pan", true);
+        NoteKnobValue(idx, KnobValueAnnouncer::TARGET_TRACK_PAN, t);
     } else {
         // VOL
         double vol = GetMediaTrackInfo_Value(t, "D_VOL");
         vol *= pow(10.0, (d * m_knob_sensitivity * 2.0) / 20.0);
         if (vol < 0.0000001) vol = 0.0; else if (vol > 3.98) vol = 3.98; // +12dB
         SetMediaTrackInfo_Value(t, "D_VOL", vol);
+        BeginKnobGesture(idx, UNDO_STATE_TRACKCFG, "SoundFirst: Adjust track volume", false);
+        if (t == m_display.track) m_display.Invalidate(DisplayModel::FIELD_VOLUME);
+        NoteKnobValue(idx, KnobValueAnnouncer::TARGET_TRACK_VOLUME, t);
     }
 }
 
+// --- GANG MODE ---
+void CSurf_SoundFirst::ToggleGangMode() {
+    m_gang_mode = !m_gang_mode;
+    m_gang_vol_db = 0.0;
+    m_gang_pan = 0.0;
+    if (m_gang_mode) {
+        RefreshSelectedTracks();
+        char m[64]; sprintf(m, "Gang On, %d tracks", (int)m_selected_tracks.size());
+        SpeakText(m);
+    } else {
+        m_selected_tracks.clear();
+        SpeakText("Gang Off");
+    }
+}
+
+void CSurf_SoundFirst::RefreshSelectedTracks() {
+    SF_API_SCOPE();
+    m_selected_tracks.clear();
+    int n = CountSelectedTracks(NULL);
+    m_selected_tracks.reserve(n);
+    for (int i = 0; i < n; i++) {
+        MediaTrack* t = GetSelectedTrack(NULL, i);
+        if (t) m_selected_tracks.push_back(t);
+    }
+}
+
+// Relative write: each track keeps its own offset (dB for volume, linear for pan)
+void CSurf_SoundFirst::ApplyGangDeltas() {
+    SF_API_SCOPE();
+    if (m_gang_vol_db == 0.0 && m_gang_pan == 0.0) return;
+
+    double gain = pow(10.0, m_gang_vol_db / 20.0);
+    PreventUIRefresh(1);
+    for (MediaTrack* t : m_selected_tracks) {
+        if (m_gang_vol_db != 0.0) {
+            double vol = GetMediaTrackInfo_Value(t, "D_VOL") * gain;
+            if (vol < 0.0000001) vol = 0.0; else if (vol > 3.98) vol = 3.98; // +12dB
+            SetMediaTrackInfo_Value(t, "D_VOL", vol);
+        }
+        if (m_gang_pan != 0.0) {
+            double pan = GetMediaTrackInfo_Value(t, "D_PAN") + m_gang_pan;
+            if (pan < -1.0) pan = -1.0; else if (pan > 1.0) pan = 1.0;
+            SetMediaTrackInfo_Value(t, "D_PAN", pan);
+        }
+    }
+    PreventUIRefresh(-1);
+    m_display.Invalidate(DisplayModel::FIELD_VOLUME);
+
+    m_gang_vol_db = 0.0;
+    m_gang_pan = 0.0;
+}
+
 void CSurf_SoundFirst::HandleKnob_MIDI(int idx, int d) {
+    SF_API_SCOPE();
     // V1.0 MIDI Logic: Restored V1.2 Context Logic
     HWND midi_editor = MIDIEditor_GetActive();
     bool sh = m_shift_pressed;
@@ -1306,23 +1540,12 @@ void CSurf_SoundFirst::HandleKnob_MIDI(int idx, int d) {
             if (d > 0) MIDIEditor_OnCommand(midi_editor, NamedCommandLookup("_OSARA_HIGHERNOTEINCHORD"));
             else MIDIEditor_OnCommand(midi_editor, NamedCommandLookup("_OSARA_LOWERNOTEINCHORD"));
         }
-        else if (idx == 2) { // K3: Grid/Pixel Move
-             // Note: V1.2 used Main IDs here? If user provided Main IDs (4xxxx), try Editor first.
-             // If these fail, we might need a lookup map. But keeping user IDs for now.
-             if (sh) { if (d > 0) MIDIEditor_OnCommand(midi_editor, 40182); else MIDIEditor_OnCommand(midi_editor, 40181); } 
-             else { if (d > 0) MIDIEditor_OnCommand(midi_editor, 40184); else MIDIEditor_OnCommand(midi_editor, 40183); }
-        }
-        else if (idx == 3) { // K4: Len Grid/Pixel
-             if (sh) { if (d > 0) MIDIEditor_OnCommand(midi_editor, 40444); else MIDIEditor_OnCommand(midi_editor, 40445); } 
-             else { if (d > 0) MIDIEditor_OnCommand(midi_editor, 40446); else MIDIEditor_OnCommand(midi_editor, 40447); }
-        }
-        else if (idx == 4) { // K5: Transpose
-             if (sh) { if (d > 0) MIDIEditor_OnCommand(midi_editor, 40179); else MIDIEditor_OnCommand(midi_editor, 40180); } 
-             else { if (d > 0) MIDIEditor_OnCommand(midi_editor, 40177); else MIDIEditor_OnCommand(midi_editor, 40178); }
-        }
-        else if (idx == 5) { // K6: Velocity
-             if (sh) { if (d > 0) MIDIEditor_OnCommand(midi_editor, 40463); else MIDIEditor_OnCommand(midi_editor, 40465); } 
-             else { if (d > 0) MIDIEditor_OnCommand(midi_editor, 40462); else MIDIEditor_OnCommand(midi_editor, 40464); }
+        else if (idx >= 2 && idx <= 5) {
+             // K3 Move (grid / Shift: 1/16 grid), K4 Length (same steps), K5 Transpose
+             // (semitone / Shift: octave), K6 Velocity (1 / Shift: 10). Accumulated for
+             // the whole drain; ApplyNoteEdits() writes the selected notes once.
+             BeginKnobGesture(idx, UNDO_STATE_ITEMS, "SoundFirst: Edit MIDI notes", false);
+             m_note_edits.Add(NoteEditBatch::NOTE_MOVE + (idx - 2), d, sh);
         }
         else if (idx == 6) { // K7: Grid Cycle (10 Steps)
              // FIX: Inverted Logic per User Request (Right = Decrease Grid? Or User meant inverted direction?)
@@ -1351,62 +1574,159 @@ void CSurf_SoundFirst::HandleKnob_MIDI(int idx, int d) {
     }
 }
 
+// noSort keeps note indices stable during the pass; MIDI_Sort runs once at the end.
+void CSurf_SoundFirst::ApplyNoteEdits() {
+    SF_API_SCOPE();
+    if (!m_note_edits.Pending()) return;
+    HWND editor = MIDIEditor_GetActive();
+    MediaItem_Take* take = editor ? MIDIEditor_GetTake(editor) : nullptr;
+    if (!take) { m_note_edits.Clear(); return; }
+
+    // One grid step in PPQ, measured at the take start (MIDI_GetGrid is in quarter notes)
+    double grid_qn = MIDI_GetGrid(take, NULL, NULL);
+    double qn0 = MIDI_GetProjQNFromPPQPos(take, 0.0);
+    double grid_ppq = MIDI_GetPPQPosFromProjQN(take, qn0 + grid_qn);
+
+    const bool no_sort = true;
+    int edited = 0;
+    for (int i = MIDI_EnumSelNotes(take, -1); i >= 0; i = MIDI_EnumSelNotes(take, i)) {
+        double start, end;
+        int pitch, vel;
+        if (!MIDI_GetNote(take, i, NULL, NULL, &start, &end, NULL, &pitch, &vel)) continue;
+        m_note_edits.ApplyTo(grid_ppq, start, end, pitch, vel);
+        MIDI_SetNote(take, i, NULL, NULL, &start, &end, NULL, &pitch, &vel, &no_sort);
+        edited++;
+    }
+    if (edited) MIDI_Sort(take);
+    m_note_edits.Clear();
+    if (!edited) Announce(AnnouncementScheduler::ANNOUNCE_STATUS, "No notes selected");
+}
+
 void CSurf_SoundFirst::HandleKnob_Audio(int idx, int d) {
+    SF_API_SCOPE();
     bool sh = m_shift_pressed;
     if (idx == 0) { // Legacy Cursor
         if (d > 0) Main_OnCommand(40105, 0); else Main_OnCommand(40104, 0);
     }
-    else if (idx == 1) { // Move Item
-         if (d > 0) Main_OnCommand(40119, 0); else Main_OnCommand(40120, 0);
-    }
-    else if (idx == 2) { // Trim Start
-         if (d > 0) Main_OnCommand(40226, 0); else Main_OnCommand(40225, 0);
-    }
-    else if (idx == 3) { // Trim End
-         if (d > 0) Main_OnCommand(40228, 0); else Main_OnCommand(40227, 0);
+    else if (idx >= 1 && idx <= 3) {
+         // K2 Move, K3 Trim Start, K4 Trim End: ItemStepMs per count (Shift: 1/10), written by
+         // ApplyItemEdits() once per drain from the gesture's snapshot of the selection
+         BeginKnobGesture(idx, UNDO_STATE_ITEMS, "SoundFirst: Edit items", false);
+         m_item_edits.Add(ItemEditBatch::ITEM_MOVE + (idx - 1), idx, d, sh);
     }
     else if (idx == 4) { // Vol
          if (d > 0) Main_OnCommand(NamedCommandLookup("_XENAKIOS_NUDGETAKEVOLUP"), 0); 
          else Main_OnCommand(NamedCommandLookup("_XENAKIOS_NUDGETAKEVOLDOWN"), 0);
+         MediaItem* first = GetSelectedMediaItem(NULL, 0);
+         if (first) NoteKnobValue(idx, KnobValueAnnouncer::TARGET_TAKE_VOLUME, first);
     }
-    else if (idx == 5) { // Fade In (Native - No SWS Required)
-         MediaTrack* t = GetSelectedTrack(NULL, 0); // Or use generic item selection?
-         // Audio Mode usually targets *Selected Items*.
-         // We iterate over selected items to apply fade.
-         int num_sel = CountSelectedMediaItems(NULL);
-         for (int i=0; i<num_sel; ++i) {
-             MediaItem* item = GetSelectedMediaItem(NULL, i);
-             if (item) {
-                  double len = GetMediaItemInfo_Value(item, "D_FADEINLEN");
-                  len += (d * 0.01); // Sensitivity
-                  if (len < 0.0) len = 0.0;
-                  SetMediaItemInfo_Value(item, "D_FADEINLEN", len);
-             }
-         }
-         if (num_sel == 0) SpeakText("Select an Item");
-         else UpdateTimeline(); // Redraw
-    }
-    else if (idx == 6) { // Fade Out (Native - No SWS Required)
-         int num_sel = CountSelectedMediaItems(NULL);
-         for (int i=0; i<num_sel; ++i) {
-             MediaItem* item = GetSelectedMediaItem(NULL, i);
-             if (item) {
-                  double len = GetMediaItemInfo_Value(item, "D_FADEOUTLEN");
-                  len += (d * 0.01); 
-                  if (len < 0.0) len = 0.0;
-                  SetMediaItemInfo_Value(item, "D_FADEOUTLEN", len);
-             }
-         }
-         if (num_sel == 0) SpeakText("Select an Item");
-         else UpdateTimeline();
+    else if (idx == 5 || idx == 6) { // Fade In / Fade Out (Native - No SWS Required)
+         BeginKnobGesture(idx, UNDO_STATE_ITEMS, "SoundFirst: Edit item fades", false);
+         m_item_edits.Add(ItemEditBatch::ITEM_FADE_IN + (idx - 5), idx, d, sh);
     }
     else if (idx == 7) { // Zoom
          if (d > 0) Main_OnCommand(1012, 0); else Main_OnCommand(1011, 0);
     }
 }
 
+// The selection is read on the first apply of a gesture only; later drains are
+// Set* calls inside one PreventUIRefresh, then a single redraw.
+void CSurf_SoundFirst::ApplyItemEdits() {
+    SF_API_SCOPE();
+    ItemEditBatch& b = m_item_edits;
+    if (!b.pending) return;
+    b.pending = false;
+
+    if (!b.snapshot_taken) {
+        b.snapshot_taken = true;
+        b.items.clear();
+        int num_sel = CountSelectedMediaItems(NULL);
+        b.items.reserve(num_sel);
+        for (int i = 0; i < num_sel; ++i) {
+            MediaItem* item = GetSelectedMediaItem(NULL, i);
+            if (!item) continue;
+            ItemEditBatch::Item s;
+            s.item = item;
+            s.take = GetActiveTake(item);
+            s.position = GetMediaItemInfo_Value(item, "D_POSITION");
+            s.length = GetMediaItemInfo_Value(item, "D_LENGTH");
+            s.fade_in = GetMediaItemInfo_Value(item, "D_FADEINLEN");
+            s.fade_out = GetMediaItemInfo_Value(item, "D_FADEOUTLEN");
+            s.start_offset = s.take ? GetMediaItemTakeInfo_Value(s.take, "D_STARTOFFS") : 0.0;
+            s.playrate = s.take ? GetMediaItemTakeInfo_Value(s.take, "D_PLAYRATE") : 1.0;
+            b.items.push_back(s);
+        }
+        if (b.items.empty()) SpeakText("Select an Item"); // Once per gesture
+    }
+    if (b.items.empty()) return;
+
+    PreventUIRefresh(1);
+    MediaItem* first = nullptr;
+    for (const ItemEditBatch::Item& s : b.items) {
+        if (!ValidatePtr2(0, s.item, "MediaItem*")) continue; // Deleted mid-gesture
+        double pos, len, fade_in, fade_out, offs;
+        b.Compute(s, pos, len, fade_in, fade_out, offs);
+        SetMediaItemInfo_Value(s.item, "D_POSITION", pos);
+        SetMediaItemInfo_Value(s.item, "D_LENGTH", len);
+        SetMediaItemInfo_Value(s.item, "D_FADEINLEN", fade_in);
+        SetMediaItemInfo_Value(s.item, "D_FADEOUTLEN", fade_out);
+        if (s.take) SetMediaItemTakeInfo_Value(s.take, "D_STARTOFFS", offs);
+        if (!first) first = s.item;
+    }
+    PreventUIRefresh(-1);
+    UpdateTimeline(); // One redraw per drain
+
+    if (first && b.last_kind == ItemEditBatch::ITEM_FADE_IN)
+        NoteKnobValue(b.last_knob, KnobValueAnnouncer::TARGET_FADE_IN, first);
+    else if (first && b.last_kind == ItemEditBatch::ITEM_FADE_OUT)
+        NoteKnobValue(b.last_knob, KnobValueAnnouncer::TARGET_FADE_OUT, first);
+}
+
+// The track array is rebuilt only after a track list change and the selected index
+// is known from the last move (or UpdateBankFromSelectedTrack): the bank is arithmetic,
+// and the selection notification this triggers skips the IP_TRACKNUMBER lookup.
+void CSurf_SoundFirst::ApplyTrackNav() {
+    SF_API_SCOPE();
+    TrackNav& nav = m_track_nav;
+    if (nav.pending == 0) return;
+    int steps = nav.pending;
+    nav.pending = 0;
+
+    if (!nav.tracks_valid) {
+        int n = CountTracks(NULL);
+        nav.tracks.resize(n);
+        for (int i = 0; i < n; i++) nav.tracks[i] = GetTrack(NULL, i);
+        nav.tracks_valid = true;
+        nav.current = -1;
+    }
+    if (nav.tracks.empty()) return;
+    if (nav.current < 0) nav.current = nav.IndexOf(GetSelectedTrack(NULL, 0));
+
+    int to = nav.Target(steps);
+    MediaTrack* track = nav.tracks[to];
+    if (to != nav.current) {
+        SetOnlyTrackSelected(track);
+        Main_OnCommand(40913, 0); // Track: Vertical scroll selected tracks into view
+        nav.current = to;
+    }
+
+    int bank = to / TrackNav::BANK_SIZE;
+    bool bank_changed = (bank != m_current_bank);
+    m_current_bank = bank;
+
+    char msg[160];
+    const char* name = (const char*)GetSetMediaTrackInfo(track, "P_NAME", NULL);
+    int len = (name && name[0]) ? snprintf(msg, sizeof(msg), "%d %s", to + 1, name)
+                                : snprintf(msg, sizeof(msg), "Track %d", to + 1);
+    if (bank_changed && len > 0 && len < (int)sizeof(msg)) {
+        snprintf(msg + len, sizeof(msg) - len, ", Bank %d", bank + 1);
+    }
+    Announce(AnnouncementScheduler::ANNOUNCE_NAVIGATION, msg);
+}
+
 // Helper for Touch Solo
 void CSurf_SoundFirst::HandleFxTouch(int knob_idx, bool touched) {
+    SF_API_SCOPE();
     if (m_current_mode != MODE_FX) return;
     
     // Respect Global Auto-Solo Toggle (Ideas/Scale Button)
@@ -1430,6 +1750,7 @@ void CSurf_SoundFirst::HandleFxTouch(int knob_idx, bool touched) {
 }
 
 void CSurf_SoundFirst::HandleKnob_FX(int idx, int d) {
+    SF_API_SCOPE();
     bool sh = m_shift_pressed;
     MediaTrack* t = GetSelectedTrack(NULL, 0);
     if (!t || m_selected_fx_index < 0) return;
@@ -1468,12 +1789,111 @@ void CSurf_SoundFirst::HandleKnob_FX(int idx, int d) {
         double current = TrackFX_GetParam(t, m_selected_fx_index, p, NULL, NULL);
         double step = (sh ? m_knob_sensitivity_shift : m_knob_sensitivity) * d;
         TrackFX_SetParam(t, m_selected_fx_index, p, current + step);
+        BeginKnobGesture(idx, UNDO_STATE_FX, "SoundFirst: Adjust FX parameter", false);
+        NoteKnobValue(idx, KnobValueAnnouncer::TARGET_FX_PARAM, t, m_selected_fx_index, p);
     }
 }
 
 void CSurf_SoundFirst::HandleSpecificKnobTouch(int i, bool o, bool f) {}
 
+// --- GESTURE UNDO ---
+// Touch bits (bytes 4/5) group knob writes into a gesture; no undo block stays open
+// across Run() ticks. The writes go straight to REAPER and EndKnobGesture records
+// them as one undo point (Undo_OnStateChangeEx2) on release, timeout, or before a
+// button / action runs. A gesture starts with the first write, so a touch without
+// a turn, or a turn with nothing under the knob, leaves no undo point.
+void CSurf_SoundFirst::BeginKnobGesture(int idx, int undo_flags, const char* desc, bool is_pan) {
+    SF_API_SCOPE();
+    if (!m_gesture_open) {
+        m_gesture_open = true;
+        m_gesture_undo_flags = 0;
+        m_gesture_knobs = 0;
+        m_gesture_pan = 0;
+    }
+    m_gesture_undo_flags |= undo_flags;
+    m_gesture_desc = desc;
+    m_gesture_knobs |= (1u << idx);
+    if (is_pan) m_gesture_pan |= (1u << idx);
+    else m_gesture_pan &= ~(1u << idx);
+    m_gesture_last_move = time_precise();
+}
+
+void CSurf_SoundFirst::EndKnobGesture() {
+    SF_API_SCOPE();
+    if (!m_gesture_open) return;
+    ApplyGangDeltas(); // Released mid-drain: the edits so far belong to this undo point
+    ApplyNoteEdits();
+    ApplyItemEdits();
+    m_item_edits.EndGesture();
+    Undo_OnStateChangeEx2(NULL, m_gesture_desc, m_gesture_undo_flags, -1);
+    m_gesture_open = false;
+    m_gesture_knobs = 0;
+    m_gesture_pan = 0;
+}
+
+// Fallback for turns without capacitive touch (gloves, M32 firmware, etc.)
+void CSurf_SoundFirst::CheckKnobGestureTimeout() {
+    SF_API_SCOPE();
+    if (!m_gesture_open) return;
+    for (int k = 0; k < 8; k++) if (m_knob_touch_state[k]) return; // Held: release closes it
+    if (time_precise() - m_gesture_last_move > m_gesture_timeout) EndKnobGesture();
+}
+
+// --- VALUE ANNOUNCER ---
+// Formatting (TrackFX_GetFormattedParamValue, mkvolstr...) runs for the first tick
+// of a gesture, once per ValueIntervalMs while moving, and once on release.
+void CSurf_SoundFirst::NoteKnobValue(int src, int target, void* obj, int fx, int param) {
+    if (!m_announce_knobs || !obj) return;
+    if (m_value_announcer.Moved(src, target, obj, fx, param, time_precise())) SpeakKnobValue(src);
+}
+
+void CSurf_SoundFirst::SpeakKnobValue(int src) {
+    SF_API_SCOPE();
+    const KnobValueAnnouncer::Source& s = m_value_announcer.sources[src];
+    char buf[256]; buf[0] = 0;
+    switch (s.target) {
+        case KnobValueAnnouncer::TARGET_FX_PARAM:
+            if (ValidatePtr2(NULL, s.obj, "MediaTrack*")) TrackFX_GetFormattedParamValue((MediaTrack*)s.obj, s.fx, s.param, buf, sizeof(buf));
+            break;
+        case KnobValueAnnouncer::TARGET_TRACK_VOLUME:
+            if (ValidatePtr2(NULL, s.obj, "MediaTrack*")) mkvolstr(buf, GetMediaTrackInfo_Value((MediaTrack*)s.obj, "D_VOL"));
+            break;
+        case KnobValueAnnouncer::TARGET_TRACK_PAN:
+            if (ValidatePtr2(NULL, s.obj, "MediaTrack*")) mkpanstr(buf, GetMediaTrackInfo_Value((MediaTrack*)s.obj, "D_PAN"));
+            break;
+        case KnobValueAnnouncer::TARGET_TAKE_VOLUME:
+            if (ValidatePtr2(NULL, s.obj, "MediaItem*")) {
+                MediaItem_Take* take = GetActiveTake((MediaItem*)s.obj);
+                if (take) mkvolstr(buf, GetMediaItemTakeInfo_Value(take, "D_VOL"));
+            }
+            break;
+        case KnobValueAnnouncer::TARGET_FADE_IN:
+        case KnobValueAnnouncer::TARGET_FADE_OUT:
+            if (ValidatePtr2(NULL, s.obj, "MediaItem*")) {
+                bool in = (s.target == KnobValueAnnouncer::TARGET_FADE_IN);
+                double len = GetMediaItemInfo_Value((MediaItem*)s.obj, in ? "D_FADEINLEN" : "D_FADEOUTLEN");
+                sprintf(buf, "Fade %s %.2f s", in ? "in" : "out", len);
+            }
+            break;
+        default:
+            break;
+    }
+    if (buf[0]) Announce(AnnouncementScheduler::ANNOUNCE_VALUE, buf);
+}
+
+// Release fallback for turns without touch and for button-driven changes
+void CSurf_SoundFirst::CheckKnobValueRelease() {
+    SF_API_SCOPE();
+    if (!m_announce_knobs) return;
+    double now = time_precise();
+    for (int k = 0; k <= KnobValueAnnouncer::NUM_KNOBS; k++) {
+        if (k < KnobValueAnnouncer::NUM_KNOBS && m_knob_touch_state[k]) continue; // Held: release speaks it
+        if (m_value_announcer.IdleExpired(k, now) && m_value_announcer.Released(k)) SpeakKnobValue(k);
+    }
+}
+
 void CSurf_SoundFirst::DumpCurrentFX() {
+    SF_API_SCOPE();
     MediaTrack* t = GetSelectedTrack(NULL, 0);
     if (!t) return;
     char fxN[256]; TrackFX_GetFXName(t, m_selected_fx_index, fxN, 256);
@@ -1489,141 +1909,246 @@ void CSurf_SoundFirst::DumpCurrentFX() {
                 ss << "; " << i << " = " << pN << "\n";
             }
             f << ss.str(); f.close();
+#ifdef _WIN32
             if (OpenClipboard(NULL)) {
                 EmptyClipboard();
                 HGLOBAL h = GlobalAlloc(GMEM_MOVEABLE, ss.str().size() + 1);
                 if (h) { memcpy(GlobalLock(h), ss.str().c_str(), ss.str().size() + 1); GlobalUnlock(h); SetClipboardData(CF_TEXT, h); }
                 CloseClipboard();
             }
+#endif
             SpeakText("Dump copied");
         }
     }
 }
 
+// Writes the API call table collected since the last dump, then starts a new window
+void CSurf_SoundFirst::DumpApiTrace() {
+    if (!ApiTracer::Enabled()) { SpeakText("API trace off"); return; }
+    std::string table = ApiTracer::Dump();
+    ApiTracer::Reset();
+    const char* rp = GetResourcePath();
+    if (!rp) return;
+    char path[1024]; snprintf(path, sizeof(path), "%s\\UserPlugins\\SoundFirst_ApiTrace.txt", rp);
+    std::ofstream f(path);
+    if (!f.is_open()) { SF_LOG(LOG_WARN, LOGCAT_GENERAL, "Cannot write %s", path); return; }
+    f << table;
+    SF_LOG(LOG_INFO, LOGCAT_GENERAL, "API trace written to %s", path);
+    SpeakText("API trace saved");
+}
+
+// One atomic pointer load per tick; the watcher thread did the file I/O and parsing
 void CSurf_SoundFirst::CheckConfigHotReload() {
-    WIN32_FILE_ATTRIBUTE_DATA d;
-    if (GetFileAttributesExA(m_config_path.c_str(), GetFileExInfoStandard, &d)) {
-        WDL_UINT64 now = ((WDL_UINT64)d.ftLastWriteTime.dwHighDateTime << 32) | d.ftLastWriteTime.dwLowDateTime;
-        if (m_last_config_time != 0 && now > m_last_config_time) { m_last_config_time = now; LoadMappingConfig(); }
+    if (!m_config_watcher || m_config_watcher->Latest() == m_config.get()) return;
+    ApplyConfig(m_config_watcher->Snapshot());
+    SF_LOG(LOG_INFO, LOGCAT_CONFIG, "Config reloaded");
+}
+
+// Main thread: adopt a snapshot. Keys absent from the INI keep their current value.
+void CSurf_SoundFirst::ApplyConfig(ConfigPtr cfg) {
+    SF_API_SCOPE();
+    if (!cfg) return;
+    m_config = cfg;
+    const Config& c = *cfg;
+
+    // Plugin sections join the mapping registry (aliases the snapshot, no copy). The
+    // registry is global: the first surface to adopt a snapshot installs it, the others
+    // find it already there and keep the cache.
+    FXMappingRegistry::SetConfigMappings(std::shared_ptr<const FXMappingTable>(cfg, &c.plugin_mappings));
+    m_gr_sources.Invalidate(); // MeterParam may have changed: re-resolve GR sources from the new mappings
+
+    if (c.announce_buttons >= 0) m_announce_buttons = (c.announce_buttons != 0);
+    if (c.announce_knobs >= 0) m_announce_knobs = (c.announce_knobs != 0);
+    if (c.announce_encoder >= 0) m_announce_encoder = (c.announce_encoder != 0);
+    if (c.announce_actions >= 0) m_announce_actions = (c.announce_actions != 0);
+    if (c.touch_auto_solo >= 0) m_touch_auto_solo = (c.touch_auto_solo != 0);
+    if (c.navigation_dwell_ms >= 0.0) m_announcer.SetDwell(AnnouncementScheduler::ANNOUNCE_NAVIGATION, c.navigation_dwell_ms / 1000.0);
+    if (c.value_interval_ms >= 0.0) m_value_announcer.interval = c.value_interval_ms / 1000.0;
+    if (c.value_dwell_ms >= 0.0) m_announcer.SetDwell(AnnouncementScheduler::ANNOUNCE_VALUE, c.value_dwell_ms / 1000.0);
+
+    if (c.gr_rate_hz >= 0.0) m_gr_clock.rate_hz = c.gr_rate_hz;
+    if (c.gr_range_db >= 0.0) m_gr_range_db = c.gr_range_db;
+    if (c.rate_hz >= 0.0) m_meter_clock.rate_hz = c.rate_hz;
+    if (c.attack_ms >= 0.0) m_meter.attack_ms = c.attack_ms;
+    if (c.hold_ms >= 0.0) m_meter.hold_ms = c.hold_ms;
+    if (c.release_db_per_sec >= 0.0) m_meter.release_db_per_sec = c.release_db_per_sec;
+
+    if (c.encoder_bar_rate > 0.0) m_encoder_nav.bar_rate = c.encoder_bar_rate;
+    if (c.encoder_section_rate > 0.0) m_encoder_nav.section_rate = c.encoder_section_rate;
+    if (c.encoder_bars_per_section > 0) m_encoder_nav.bars_per_section = c.encoder_bars_per_section;
+    if (c.track_repeat_ms > 0.0) m_track_nav.repeat_ms = c.track_repeat_ms;
+    if (c.track_max_jump > 0) m_track_nav.max_jump = c.track_max_jump;
+    if (c.item_step_ms > 0.0) m_item_edits.seconds_per_count = c.item_step_ms / 1000.0;
+    if (c.note_step_counts > 0) m_note_edits.counts_per_step = c.note_step_counts;
+
+    if (c.tick_budget_ms > 0.0) m_tick_budget.budget = c.tick_budget_ms / 1000.0;
+    if (c.api_trace >= 0) ApiTracer::Enable(c.api_trace != 0);
+
+    if (c.log_level >= 0) Logger::Instance().SetLevel(c.log_level);
+    if (c.log_categories >= 0) Logger::Instance().SetCategories(c.log_categories);
+    if (c.log_max_kb >= 0) Logger::Instance().SetMaxBytes(c.log_max_kb * 1024);
+
+    // Apply loaded modes if any were found
+    if (!c.modes.empty()) {
+        m_available_modes = c.modes;
+        // Clamp current index if necessary
+        if (m_current_mode_idx >= (int)m_available_modes.size()) {
+            m_current_mode_idx = 0;
+        }
     }
 }
 
-void CSurf_SoundFirst::LoadMappingConfig() {
-    g_plugin_mappings.clear(); m_nhl_actions.clear(); m_mode_actions.clear();
-    
-    // Keep current accessibility and modes as defaults (already initialized in constructor)
-    // They will be overridden if found in INI
-    
+// Runs on the constructor (first load) and on the watcher thread: no REAPER API,
+// no surface state, only the file.
+std::string CSurf_SoundFirst::ConfigPath() {
+    const char* rPath = GetResourcePath();
+    if (!rPath) return std::string();
+    char iniPath[1024]; snprintf(iniPath, sizeof(iniPath), "%s\\UserPlugins\\SoundFirst_PRO.ini", rPath);
+    return iniPath;
+}
+
+ConfigPtr CSurf_SoundFirst::ParseConfig(const std::string& path) {
+    std::shared_ptr<Config> cfg = std::make_shared<Config>();
+    Config& c = *cfg;
+
     // Default Actions (Sane fallbacks)
-    m_nhl_actions["PLAY"] = "40044";
-    m_nhl_actions["STOP"] = "1016";
-    m_nhl_actions["REC"] = "1013";
-    m_nhl_actions["LOOP"] = "1068";
-    m_nhl_actions["BROWSER"] = "40271"; // Media Explorer
-    m_nhl_actions["UNDO"] = "40029";
-    m_nhl_actions["QUANTIZE"] = "40469";
-    m_nhl_actions["PRESET_UP"] = "@BANK_UP";
-    m_nhl_actions["PRESET_DOWN"] = "@BANK_DOWN";
-    m_nhl_actions["ENC_PRESS"] = "40294";
-
-    std::ifstream f(m_config_path);
-    if (!f.is_open()) return;
-    
-    std::string line, sec;
-    std::vector<std::string> loaded_modes; // Temporary storage for modes
-    
-    while (std::getline(f, line)) {
-        line = trim(line); if (line.empty() || line[0] == ';') continue;
-        if (line[0] == '[' && line.back() == ']') { sec = trim(line.substr(1, line.size() - 2)); continue; }
-        size_t eq = line.find('='); if (eq == std::string::npos) continue;
-        std::string k = trim(line.substr(0, eq)), v = trim(line.substr(eq+1));
-        
+    c.nhl_actions["PLAY"] = "40044";
+    c.nhl_actions["STOP"] = "1016";
+    c.nhl_actions["REC"] = "1013";
+    c.nhl_actions["LOOP"] = "1068";
+    c.nhl_actions["BROWSER"] = "40271"; // Media Explorer
+    c.nhl_actions["UNDO"] = "40029";
+    c.nhl_actions["QUANTIZE"] = "40469";
+    c.nhl_actions["PRESET_UP"] = "@BANK_UP";
+    c.nhl_actions["PRESET_DOWN"] = "@BANK_DOWN";
+    c.nhl_actions["ENC_PRESS"] = "40294";
+
+    IniFile ini;
+    if (!ini.Load(path.c_str())) return cfg;
+
+    ini.ForEach([&](std::string_view sec, std::string_view k, std::string_view v, int line) {
+        int iv = 0;
+        double dv = 0.0;
+        auto as_int = [&](int& out) { if (IniParseInt(v, iv)) out = iv; else ini.AddError(line, "invalid integer"); };
+        auto as_flag = [&](int& out) { if (IniParseInt(v, iv)) out = (iv != 0); else ini.AddError(line, "invalid integer"); };
+        auto as_double = [&](double& out) { if (IniParseDouble(v, dv)) out = dv; else ini.AddError(line, "invalid number"); };
+
         // Section: ACCESSIBILITY
         if (sec == "ACCESSIBILITY") {
-            if (k == "AnnounceButtons") m_announce_buttons = (std::stoi(v) != 0);
-            else if (k == "AnnounceKnobs") m_announce_knobs = (std::stoi(v) != 0);
-            else if (k == "AnnounceEncoder") m_announce_encoder = (std::stoi(v) != 0);
-            else if (k == "AnnounceActions") m_announce_actions = (std::stoi(v) != 0);
-            else if (k == "TouchAutoSolo") m_touch_auto_solo = (std::stoi(v) != 0);
+            if (k == "AnnounceButtons") as_flag(c.announce_buttons);
+            else if (k == "AnnounceKnobs") as_flag(c.announce_knobs);
+            else if (k == "AnnounceEncoder") as_flag(c.announce_encoder);
+            else if (k == "AnnounceActions") as_flag(c.announce_actions);
+            else if (k == "TouchAutoSolo") as_flag(c.touch_auto_solo);
+            else if (k == "NavigationDwellMs") as_double(c.navigation_dwell_ms);
+            else if (k == "ValueIntervalMs") as_double(c.value_interval_ms);
+            else if (k == "ValueDwellMs") as_double(c.value_dwell_ms);
+        }
+        
+        // Section: METER (sampling rate and ballistics)
+        else if (sec == "METER") {
+            if (k == "GrRateHz") as_double(c.gr_rate_hz);
+            else if (k == "GrRangeDb") as_double(c.gr_range_db);
+            else if (k == "RateHz") as_double(c.rate_hz);
+            else if (k == "AttackMs") as_double(c.attack_ms);
+            else if (k == "HoldMs") as_double(c.hold_ms);
+            else if (k == "ReleaseDbPerSec") as_double(c.release_db_per_sec);
+        }
+
+        // Section: ENCODER (cursor / track navigation speed scaling)
+        else if (sec == "ENCODER") {
+            if (k == "BarRate") as_double(c.encoder_bar_rate);
+            else if (k == "SectionRate") as_double(c.encoder_section_rate);
+            else if (k == "BarsPerSection") as_int(c.encoder_bars_per_section);
+            else if (k == "TrackRepeatMs") as_double(c.track_repeat_ms);
+            else if (k == "TrackMaxJump") as_int(c.track_max_jump);
         }
 
+        // Section: AUDIO (native item editing)
+        else if (sec == "AUDIO") {
+            if (k == "ItemStepMs") as_double(c.item_step_ms);
+        }
+
+        // Section: MIDI (native note editing)
+        else if (sec == "MIDI") {
+            if (k == "NoteStepCounts") as_int(c.note_step_counts);
+        }
+
+        // Section: PERFORMANCE (Run() time budget)
+        else if (sec == "PERFORMANCE") {
+            if (k == "TickBudgetMs") as_double(c.tick_budget_ms);
+            else if (k == "ApiTrace") as_int(c.api_trace);
+        }
+
+        // Section: LOGGING (async logger level and rotation size)
+        else if (sec == "LOGGING") {
+            if (k == "Level") c.log_level = Logger::ParseLevel(std::string(v), LOG_INFO);
+            else if (k == "Categories") c.log_categories = Logger::ParseCategories(std::string(v));
+            else if (k == "MaxSizeKB") { int kb = -1; as_int(kb); if (kb >= 0) c.log_max_kb = kb; }
+        }
         
         // Section: MODES
         else if (sec == "MODES") {
-            if (k.find("Mode") == 0) {
+            if (IniStartsWith(k, "Mode")) {
                 // Rename legacy "EDIT" mode to "AUDIO" and "FX" to "PLUGIN"
-                std::string mode_val = (v == "EDIT") ? "AUDIO" : (v == "FX" ? "PLUGIN" : v);
-                loaded_modes.push_back(mode_val);
+                std::string_view mode_val = (v == "EDIT") ? std::string_view("AUDIO") : (v == "FX" ? std::string_view("PLUGIN") : v);
+                c.modes.emplace_back(mode_val);
             }
         }
         
         // Section: NHL_ACTIONS
-        else if (sec == "NHL_ACTIONS") m_nhl_actions[k] = v;
+        else if (sec == "NHL_ACTIONS") c.nhl_actions[std::string(k)] = std::string(v);
         
         // Section: MODE-specific actions (e.g. MODE_MIXER, MODE_FX)
-        else if (sec.find("MODE_") == 0) {
+        else if (IniStartsWith(sec, "MODE_")) {
             // Determine which mode this is for
-            std::string mode_name = sec.substr(5); // Remove "MODE_" prefix
+            std::string_view mode_name = sec.substr(5); // Remove "MODE_" prefix
             ControlMode mode = MODE_MIXER; // default
             if (mode_name == "MIXER") mode = MODE_MIXER;
             else if (mode_name == "FX" || mode_name == "PLUGIN") mode = MODE_FX;
             else if (mode_name == "MIDI") mode = MODE_MIDI;
             else if (mode_name == "EDIT" || mode_name == "AUDIO") mode = MODE_AUDIO;
             
-            m_mode_actions[mode][k] = v;
+            c.mode_actions[mode][std::string(k)] = std::string(v);
         }
         
         // Legacy NHL mode sections
-        else if (sec == "NHL_ACTIONS_MIXER") m_mode_actions[MODE_MIXER][k] = v;
-        else if (sec == "NHL_ACTIONS_FX") m_mode_actions[MODE_FX][k] = v;
+        else if (sec == "NHL_ACTIONS_MIXER") c.mode_actions[MODE_MIXER][std::string(k)] = std::string(v);
+        else if (sec == "NHL_ACTIONS_FX") c.mode_actions[MODE_FX][std::string(k)] = std::string(v);
         
-        // Plugin mappings
+        // Plugin mappings: KnobN / ShiftKnobN / TouchN fill page 1, NHL keys the button table
         else {
-            try {
-                if (k.find("ShiftKnob") == 0) g_plugin_mappings[sec][1000 + (std::stoi(k.substr(9)) - 1)] = std::stoi(v);
-                else if (k.find("Knob") == 0) g_plugin_mappings[sec][std::stoi(k.substr(4)) - 1] = std::stoi(v);
-                else if (k.find("Touch") == 0) g_plugin_mappings[sec][2000 + (std::stoi(k.substr(5)) - 1)] = std::stoi(v);
-                
-                else if (k == "IDEAS") g_plugin_mappings[sec][3000] = std::stoi(v);
-                else if (k == "QUANTIZE") g_plugin_mappings[sec][3001] = std::stoi(v);
-                else if (k == "UNDO") g_plugin_mappings[sec][3002] = std::stoi(v);
-                else if (k == "METRO") g_plugin_mappings[sec][3003] = std::stoi(v);
-                else if (k == "LOOP") g_plugin_mappings[sec][3004] = std::stoi(v);
-                else if (k == "MUTE") g_plugin_mappings[sec][3005] = std::stoi(v);
-                else if (k == "SOLO") g_plugin_mappings[sec][3006] = std::stoi(v);
-                else if (k == "PRESET_UP") g_plugin_mappings[sec][3007] = std::stoi(v);
-                else if (k == "PRESET_DOWN") g_plugin_mappings[sec][3008] = std::stoi(v);
-                else if (k == "PLAY") g_plugin_mappings[sec][3009] = std::stoi(v);
-                else if (k == "STOP") g_plugin_mappings[sec][3010] = std::stoi(v);
-                else if (k == "REC") g_plugin_mappings[sec][3011] = std::stoi(v);
-                else if (k == "ENC_PRESS") g_plugin_mappings[sec][2017] = std::stoi(v);
-                else if (k == "REC") g_plugin_mappings[sec][2018] = std::stoi(v);
-            } catch (...) {}
-        }
-    }
-    
-    // Apply loaded modes if any were found
-    if (!loaded_modes.empty()) {
-        m_available_modes = loaded_modes;
-        // Clamp current index if necessary
-        if (m_current_mode_idx >= (int)m_available_modes.size()) {
-            m_current_mode_idx = 0;
+            int n = 0, btn = -1;
+            int FXKnobMap::* field = nullptr;
+            if (IniStartsWith(k, "ShiftKnob")) { if (IniParseInt(k.substr(9), n)) field = &FXKnobMap::shift_param_id; }
+            else if (IniStartsWith(k, "Knob")) { if (IniParseInt(k.substr(4), n)) field = &FXKnobMap::param_id; }
+            else if (IniStartsWith(k, "Touch")) { if (IniParseInt(k.substr(5), n)) field = &FXKnobMap::touch_param_id; }
+            else btn = MappableButtonFromKey(k);
+            if (!field && btn < 0) return;
+            if (field && (n < 1 || n > 8)) { ini.AddError(line, "knob number out of range"); return; }
+            if (!IniParseInt(v, iv)) { ini.AddError(line, "invalid integer"); return; }
+
+            // Created on the first valid key, so stray sections never shadow a factory map
+            FXMapping& m = c.plugin_mappings[std::string(sec)];
+            if (m.pages.empty()) {
+                m.plugin_name_signature = std::string(sec);
+                m.pages.resize(1);
+                m.pages[0].name = "Main";
+            }
+            if (field) m.pages[0].knobs[n - 1].*field = iv;
+            else m.buttons[btn] = InternString(v);
         }
+    });
+
+    for (const IniError& e : ini.Errors()) {
+        SF_LOG(LOG_WARN, LOGCAT_CONFIG, "%s:%d: %s", path, e.line, e.message);
     }
+    return cfg;
 }
 
 void CSurf_SoundFirst::SwitchMode(ControlMode m) { m_current_mode = m; }
 void CSurf_SoundFirst::LogDebug(const char* text) {
-    char* appData = getenv("APPDATA");
-    if (appData) {
-        char path[512]; sprintf(path, "%s\\REAPER\\UserPlugins\\SoundFirst_Logs.txt", appData);
-        FILE* f = fopen(path, "a");
-        if (f) {
-            SYSTEMTIME st; GetLocalTime(&st);
-            fprintf(f, "[%02d:%02d:%02d] %s\n", st.wHour, st.wMinute, st.wSecond, text);
-            fclose(f);
-        }
-    }
+    Logger::Instance().Write(LOG_INFO, text); // Non-blocking: formatted and written by the flusher thread
 }
 
 // Header for string safety
@@ -1632,20 +2157,27 @@ void CSurf_SoundFirst::LogDebug(const char* text) {
 // Header for string safety
 #include <string>
 
+// Status messages (toggles, confirmations). Queued, spoken at the end of Run().
 void CSurf_SoundFirst::SpeakText(const char* text) {
-    if (!text) return;
+    Announce(AnnouncementScheduler::ANNOUNCE_STATUS, text);
+}
 
-    // if (ShowConsoleMsg) ShowConsoleMsg((std::string("[A61] ") + text + "\n").c_str());
+void CSurf_SoundFirst::Announce(int category, const char* text) {
+    m_announcer.Post(category, text, time_precise());
+}
+
+void CSurf_SoundFirst::FlushAnnouncements() {
+    SF_API_SCOPE();
+    char utterance[768];
+    if (!m_announcer.Collect(time_precise(), utterance, sizeof(utterance))) return;
 
     // OSARA via g_rec (Legacy/Direct Access as requested)
-    static void (*osara_outputMessage)(const char*) = NULL;
-    
-    if (!osara_outputMessage && g_rec) {
-        osara_outputMessage = (void (*)(const char*))g_rec->GetFunc("osara_outputMessage");
+    if (!m_osara_output && g_rec) {
+        m_osara_output = (void (*)(const char*))g_rec->GetFunc("osara_outputMessage");
     }
 
-    if (osara_outputMessage) {
-        osara_outputMessage(text);
+    if (m_osara_output) {
+        m_osara_output(utterance);
     }
 }
 
@@ -1655,10 +2187,10 @@ void CSurf_SoundFirst::SendMidi(unsigned char s, unsigned char d1, unsigned char
 
 
 void CSurf_SoundFirst::SendSysex(unsigned char* d, int l) {
-    if (m_midi_out) { 
-        // Safer vector-based allocation
-        std::vector<char> evt(sizeof(MIDI_event_t) + l);
-        MIDI_event_t* e = (MIDI_event_t*)evt.data();
+    if (m_midi_out && l > 0 && l <= 256) { 
+        // Stack storage: MIDI_event_t header + payload (handshake and one-off frames)
+        alignas(MIDI_event_t) unsigned char buf[sizeof(MIDI_event_t) + 256];
+        MIDI_event_t* e = (MIDI_event_t*)buf;
         e->frame_offset = 0; 
         e->size = l; 
         memcpy(e->midi_message, d, l); 
@@ -1668,7 +2200,12 @@ void CSurf_SoundFirst::SendSysex(unsigned char* d, int l) {
 
 
 
-void CSurf_SoundFirst::SetSurfaceVolume(MediaTrack* t, double v) {}
+void CSurf_SoundFirst::SetSurfaceVolume(MediaTrack* t, double v) {
+    if (t && t == m_display.track) m_display.Invalidate(DisplayModel::FIELD_VOLUME);
+}
+void CSurf_SoundFirst::SetTrackTitle(MediaTrack* t, const char* title) {
+    if (t && t == m_display.track) m_display.Invalidate(DisplayModel::FIELD_TRACK_LINE);
+}
 void CSurf_SoundFirst::SetSurfacePan(MediaTrack* t, double p) {}
 void CSurf_SoundFirst::SetSurfaceMute(MediaTrack* t, bool m) {}
 void CSurf_SoundFirst::SetSurfaceSolo(MediaTrack* t, bool s) {}
@@ -1687,47 +2224,15 @@ void CSurf_SoundFirst::ResetIdleTimer() {
     }
 }
 
-void CSurf_SoundFirst::SendLCDMessage(unsigned char cmd, const char* text) {
+void CSurf_SoundFirst::SendLCDMessage(unsigned char cmd, const char* text, unsigned char idx) {
     if (!m_midi_out || !text) return;
-    
-    // Header (10) + Cmd (1) + Val (1) + Idx (1) + Text (N) + F7 (1)
-    std::vector<unsigned char> sysex;
-    sysex.reserve(128);
-    
-    // F0 00 21 09 00 00 44 43 01 00
-    sysex.push_back(0xF0); sysex.push_back(0x00); sysex.push_back(0x21); sysex.push_back(0x09);
-    sysex.push_back(0x00); sysex.push_back(0x00); sysex.push_back(0x44); sysex.push_back(0x43);
-    sysex.push_back(0x01); sysex.push_back(0x00);
-    
-    sysex.push_back(cmd);
-    sysex.push_back(0); // Value
-    sysex.push_back(0); // Index
-    
-    // Clean string from non-ASCII
-    for (int i=0; text[i] != 0 && i < 64; i++) {
-        if (text[i] >= 32 && text[i] < 127) sysex.push_back((unsigned char)text[i]);
-    }
-    
-    sysex.push_back(0xF7);
-    SendSysex(sysex.data(), (int)sysex.size());
+    // Header (10) + Cmd (1) + Val (1) + Idx (1) + Text (N) + F7 (1), built in place
+    m_midi_out->SendMsg(m_lcd_frame.BuildText(cmd, idx, text), 0);
 }
 
-void CSurf_SoundFirst::SendLCDValue(unsigned char cmd, int val) {
+void CSurf_SoundFirst::SendLCDValue(unsigned char cmd, int val, unsigned char idx) {
     if (!m_midi_out) return;
-    
-    std::vector<unsigned char> sysex;
-    sysex.reserve(16);
-    
-    sysex.push_back(0xF0); sysex.push_back(0x00); sysex.push_back(0x21); sysex.push_back(0x09);
-    sysex.push_back(0x00); sysex.push_back(0x00); sysex.push_back(0x44); sysex.push_back(0x43);
-    sysex.push_back(0x01); sysex.push_back(0x00);
-    
-    sysex.push_back(cmd);
-    sysex.push_back((unsigned char)(val & 0x7F)); // Clamp 0-127
-    sysex.push_back(0); // Index
-    
-    sysex.push_back(0xF7);
-    SendSysex(sysex.data(), (int)sysex.size());
+    m_midi_out->SendMsg(m_value_frame.BuildValue(cmd, val, idx), 0);
 }
 
 
@@ -1753,187 +2258,273 @@ void CSurf_SoundFirst::SendMidiCC(int cc, int val) {
 }
 
 void CSurf_SoundFirst::UpdateDisplay() {
-    static char last_line1[64] = "";
-    static char last_line2_name[64] = "";
-    static char last_line2_val[64] = "";
-    static bool last_screensaver = false;
-    static bool last_browser_mode = false;
-    static int last_track_available = -1; // -1 Force update
-    static int last_track_selected = -1;
-    static int last_mode_force = -1; // 0=Mixer, 1=Plugin
-
-    // Force Mode refresh periodically? No, just on change.
-    
+    SF_API_SCOPE();
+    DisplayModel& dm = m_display;
+
     // 1. Screensaver Priority
-    if (time_precise() - m_last_input_time > 10.0) { // 10s Timeout
-        if (!m_screensaver_active) {
-            m_screensaver_active = true;
-        }
+    if (!m_screensaver_active && time_precise() - m_last_input_time > 10.0) { // 10s Timeout
+        m_screensaver_active = true;
     }
 
-    if (m_screensaver_active) {
-        if (!last_screensaver) {
-            m_screensaver_active = true;
-            last_screensaver = true;
+    if (m_screensaver_active != dm.screensaver) {
+        dm.screensaver = m_screensaver_active;
+        if (m_screensaver_active) {
             // Force Plugin Mode for custom text (Screensaver)
-            if (last_mode_force != 1) { SendMidiCC(5, 1); last_mode_force = 1; }
-            
-            SendLCDMessage(0x48, "SoundFirst PRO                  "); 
-            SendLCDMessage(0x72, "                                ");               
-            SendLCDMessage(0x73, "          Idle Mode             "); 
-            SendLCDValue(0x49, 0); 
-            SendLCDValue(0x40, 0); // Track Empty (maybe helps clear?)
+            if (DisplayModel::Update(dm.mode, 1)) SendMidiCC(5, 1);
+            if (DisplayModel::Update(dm.track_line, "SoundFirst PRO                  ")) SendLCDMessage(0x48, dm.track_line);
+            if (DisplayModel::Update(dm.slot_name[0], "                                ")) SendLCDMessage(0x72, dm.slot_name[0]);
+            if (DisplayModel::Update(dm.slot_value[0], "          Idle Mode             ")) SendLCDMessage(0x73, dm.slot_value[0]);
+            for (int i = 0; i < DisplayModel::NUM_SLOTS; i++) SetMeterField(0, i);
+            if (DisplayModel::Update(dm.track_state, 0)) SendLCDValue(0x40, 0); // Track Empty (maybe helps clear?)
+            SF_LOG(LOG_DEBUG, LOGCAT_DISPLAY, "Screensaver on");
+            return;
         }
-        return; 
+        // 2. Wake Logic: re-render everything, unchanged fields are not resent
+        SF_LOG(LOG_DEBUG, LOGCAT_DISPLAY, "Screensaver off, display resync");
+        dm.InvalidateAll();
     }
+    if (m_screensaver_active) return;
 
-    // 2. Wake Logic
-    if (last_screensaver) {
-        last_screensaver = false;
-        last_line1[0] = 0; 
-        last_line2_name[0] = 0; 
-        last_line2_val[0] = 0;
-        last_track_available = -1; // Force status resend
+    // 3. Surface-side state changes (mode, FX cursor, BROWSER selection)
+    if (dm.key_browser != m_browser_mode_selection || (m_browser_mode_selection && dm.key_mode_idx != m_current_mode_idx)) {
+        dm.key_browser = m_browser_mode_selection;
+        dm.key_mode_idx = m_current_mode_idx;
+        dm.InvalidateAll();
     }
-    
-    // 3. Browser Mode Priority (User Request: "No cambia modo")
+    if (dm.key_mode != (int)m_current_mode) {
+        dm.key_mode = (int)m_current_mode;
+        dm.Invalidate(DisplayModel::FIELD_MODE | DisplayModel::FIELD_VOLUME);
+        dm.InvalidateSlots(1, 1);
+    }
+    if (dm.key_fx_index != m_selected_fx_index || dm.key_fx_page != m_fx_page) {
+        dm.key_fx_index = m_selected_fx_index;
+        dm.key_fx_page = m_fx_page;
+        dm.InvalidateSlots(1, 1);
+    }
+
+    // Steady state: nothing formatted, nothing sent
+    if (!dm.IsDirty()) return;
+    RenderDisplayFields();
+}
+
+// Formats only the dirty fields and sends the ones whose content changed
+void CSurf_SoundFirst::RenderDisplayFields() {
+    SF_API_SCOPE();
+    DisplayModel& dm = m_display;
+    unsigned int dirty = dm.dirty;
+    unsigned int names = dm.slot_name_dirty;
+    unsigned int values = dm.slot_value_dirty;
+    dm.dirty = 0; dm.slot_name_dirty = 0; dm.slot_value_dirty = 0;
+
+    // BROWSER Mode Priority (User Request: "No cambia modo")
     if (m_browser_mode_selection) {
-        // Force refresh if entering this mode
-        if (!last_browser_mode) {
-             last_line1[0] = 0; last_line2_name[0] = 0; last_line2_val[0] = 0;
-             last_browser_mode = true;
-             // Force Plugin Mode to show "Select Mode"
-             if (last_mode_force != 1) { SendMidiCC(5, 1); last_mode_force = 1; }
-        }
-        
-        SendLCDMessage(0x48, "SELECT MODE                     ");
+        // Force Plugin Mode to show "Select Mode"
+        if (DisplayModel::Update(dm.mode, 1)) SendMidiCC(5, 1);
+        if (DisplayModel::Update(dm.track_line, "SELECT MODE                     ")) SendLCDMessage(0x48, dm.track_line);
         char modeBuf[64]; sprintf(modeBuf, "Current: %-23s", m_available_modes[m_current_mode_idx].c_str());
-        SendLCDMessage(0x72, modeBuf); // Line 2 Name
-        SendLCDMessage(0x73, "                                "); // Line 2 Val (Clear)
+        if (DisplayModel::Update(dm.slot_name[0], modeBuf)) SendLCDMessage(0x72, dm.slot_name[0]); // Line 2 Name
+        if (DisplayModel::Update(dm.slot_value[0], "                                ")) SendLCDMessage(0x73, dm.slot_value[0]); // Line 2 Val (Clear)
         // Force Track Available so screen stays on?
-        SendLCDValue(0x40, 1); 
-        return; // Important: Don't run standard logic
+        if (DisplayModel::Update(dm.track_state, 1)) SendLCDValue(0x40, 1);
+        return;
     }
-    
-    if (last_browser_mode) {
-        last_browser_mode = false;
-        // Force refresh on exit
-        last_line1[0] = 0; last_line2_name[0] = 0; last_line2_val[0] = 0;
-        last_track_available = -1;
-    }
-
-    // 4. Active Display Logic
-    char line1[64];
-    char line2_name[64];
-    char line2_val[64];
-    int track_available = 0; // 0=Empty, 1=Audio
-    
-    // Line 1: Track Context
+
     MediaTrack* tr = GetSelectedTrack(0, 0);
-    if (tr) {
-        track_available = 1;
-        char name[256]; name[0] = 0;
-        // FIX: GetSetMediaTrackInfo with a pointer as 3rd arg SETS the value.
-        // We must pass NULL to GET the pointer.
-        char* pName = (char*)GetSetMediaTrackInfo(tr, "P_NAME", NULL);
-        if (pName) {
-            strncpy(name, pName, 255);
-            name[255] = 0;
-        }
+    dm.track = tr;
 
-        if (strlen(name) == 0) sprintf(line1, "Track %d                        ", (int)GetMediaTrackInfo_Value(tr, "IP_TRACKNUMBER"));
-        else sprintf(line1, "%d. %-.24s", (int)GetMediaTrackInfo_Value(tr, "IP_TRACKNUMBER"), name); // Limit to 24 chars safely
-    } else {
-        track_available = 0; // Host tells Controller: EMPTY
-        sprintf(line1, "No Track Selected               ");
+    // Mode Switch (CC 5): Plugin layout for FX, Native Mixer otherwise
+    if (dirty & DisplayModel::FIELD_MODE) {
+        int desired_mode = (m_current_mode == MODE_FX) ? 1 : 0;
+        if (DisplayModel::Update(dm.mode, desired_mode)) SendMidiCC(5, desired_mode);
     }
 
-    // Determine Mode for Display
-    int desired_mode = 0; // Default Mixer
-    
-    // Line 2: Mode Context
-    if (m_current_mode == MODE_FX) {
-        desired_mode = 1; // Plugin Mode
+    // Track Available Status (Critical for Display State)
+    if (dirty & DisplayModel::FIELD_TRACK_STATE) {
+        // 0x40 = Track Type (0=Empty, 1=Audio, 6=Master)
+        int track_available = tr ? 1 : 0;
+        if (DisplayModel::Update(dm.track_state, track_available)) {
+            SendLCDValue(0x40, track_available);
+            SendLCDValue(0x42, track_available); // Selected state
+        }
+    }
+
+    // Line 1: Track Context
+    if (dirty & DisplayModel::FIELD_TRACK_LINE) {
+        char line1[64];
         if (tr) {
-             char fxName[256];
-             if (TrackFX_GetFXName(tr, m_selected_fx_index, fxName, 256)) {
-                 sprintf(line2_name, "FX: %-24s", fxName);
-             } else {
-                 sprintf(line2_name, "FX: (Empty)                     ");
-             }
-             sprintf(line2_val, "Page: %d                       ", m_fx_page + 1);
+            // FIX: GetSetMediaTrackInfo with a pointer as 3rd arg SETS the value.
+            // We must pass NULL to GET the pointer.
+            const char* pName = (const char*)GetSetMediaTrackInfo(tr, "P_NAME", NULL);
+            int num = (int)GetMediaTrackInfo_Value(tr, "IP_TRACKNUMBER");
+            if (!pName || !pName[0]) sprintf(line1, "Track %d                        ", num);
+            else snprintf(line1, sizeof(line1), "%d. %-.24s", num, pName); // Limit to 24 chars safely
         } else {
-            sprintf(line2_name, "FX Mode                         ");
-            sprintf(line2_val, "No Track                        ");
+            sprintf(line1, "No Track Selected               ");
         }
-    } else {
-        // Mixer Mode (Volume/Pan). Keep Native Mixer?
-        // Actually, if we want custom strings to work, we might need Plugin Mode even for Mixer?
-        // But let's try Native Mixer since user liked the "Vol" bar layout.
-        desired_mode = 0; 
+        if (DisplayModel::Update(dm.track_line, line1)) SendLCDMessage(0x48, line1);
+    }
+
+    // Bottom Line Logic: Mixer vs FX
+    if (m_current_mode == MODE_FX) {
+        // Use PARAM DISPLAY (0x72/0x73), slot 0 carries plugin + page
+        if (names & 1) {
+            char line2_name[64];
+            char fxName[256];
+            if (!tr) sprintf(line2_name, "FX Mode                         ");
+            else if (TrackFX_GetFXName(tr, m_selected_fx_index, fxName, 256)) snprintf(line2_name, sizeof(line2_name), "FX: %-24.56s", fxName);
+            else sprintf(line2_name, "FX: (Empty)                     ");
+            if (DisplayModel::Update(dm.slot_name[0], line2_name)) SendLCDMessage(0x72, line2_name);
+        }
+        if (values & 1) {
+            char line2_val[64];
+            if (tr) sprintf(line2_val, "Page: %d                       ", m_fx_page + 1);
+            else sprintf(line2_val, "No Track                        ");
+            if (DisplayModel::Update(dm.slot_value[0], line2_val)) SendLCDMessage(0x73, line2_val);
+        }
+    } else if (dirty & DisplayModel::FIELD_VOLUME) {
+        // MODE_MIXER: Use VOLUME TEXT (0x46)
+        char line2_val[64];
         if (tr) {
-            double vol = GetMediaTrackInfo_Value(tr, "D_VOL");
-            double volIdx = MKVOL2DB(vol);
-            
-            // For Mixer Mode, we populate the strings, but we will send them to DIFFERENT addresses
-            sprintf(line2_name, "Volume                          "); // Just label (or Pan?)
-            
+            double volIdx = MKVOL2DB(GetMediaTrackInfo_Value(tr, "D_VOL"));
             if (volIdx < -140.0) sprintf(line2_val, "-inf dB                         ");
             else sprintf(line2_val, "%.1f dB                         ", volIdx);
         } else {
-             sprintf(line2_name, "Mixer Mode                      ");
-             sprintf(line2_val, "                                ");
+            sprintf(line2_val, "                                ");
         }
+        if (DisplayModel::Update(dm.volume_text, line2_val)) SendLCDMessage(0x46, line2_val); // 0x46 = Volume Text
     }
-    
-    // 5. SEND UPDATES
-    
-    // Mode Switch (CC 5)
-    if (desired_mode != last_mode_force) {
-        SendMidiCC(5, desired_mode); 
-        last_mode_force = desired_mode;
+}
+
+// Samples at m_meter_clock.rate_hz (not Run() frequency) and shapes locally
+void CSurf_SoundFirst::UpdateMeter() {
+    SF_API_SCOPE();
+    // Only update if screen is active (save USB bandwidth)
+    if (m_screensaver_active) return;
+    double now = time_precise();
+    if (m_gr_meter_mode) { UpdateGrMeter(now); return; }
+    if (!m_meter_clock.Due(now)) return;
+    if (m_current_mode == MODE_MIXER) { UpdateBankMeters(now); return; }
+
+    // Single track: slot 0 only
+    for (int i = 1; i < DisplayModel::NUM_SLOTS; i++) SetMeterField(0, i);
+    MediaTrack* tr = GetSelectedTrack(0, 0);
+    if (!tr) {
+        m_meter.Reset();
+        SetMeterField(0); // No track = 0
+        return;
+    }
+
+    // PEAK MODE
+    double peakL = Track_GetPeakInfo(tr, 0);
+    double peakR = Track_GetPeakInfo(tr, 1);
+    double maxPeak = (peakL > peakR) ? peakL : peakR;
+    double db = m_meter.Process(MeterAmpToDb(maxPeak), now);
+    SetMeterField(QuantizeMeterDb(db)); // -60dB (0) to +6dB (127)
+}
+
+// MIXER MODE: meters the 8 tracks of m_current_bank on their own slots.
+// One pass reads all peaks, one vectorizable pass converts them to dB.
+void CSurf_SoundFirst::UpdateBankMeters(double now) {
+    SF_API_SCOPE();
+    if (m_bank_tracks_bank != m_current_bank) {
+        m_bank_tracks_bank = m_current_bank;
+        for (int i = 0; i < 8; i++) {
+            m_bank_tracks[i] = GetTrack(NULL, (m_current_bank * 8) + i);
+            m_bank_meters[i].Reset();
+        }
     }
-    
-    // Track Available Status (Critical for Display State)
-    if (track_available != last_track_available) {
-        // 0x40 = Track Type (0=Empty, 1=Audio, 6=Master)
-        // If track is MASTER, maybe send 6? For now use 1 for active.
-        SendLCDValue(0x40, track_available); 
-        // Also send Selected state? (0x42)
-        SendLCDValue(0x42, track_available); 
-        last_track_available = track_available;
+
+    float peakL[8], peakR[8], db[8];
+    for (int i = 0; i < 8; i++) {
+        MediaTrack* t = m_bank_tracks[i];
+        peakL[i] = t ? (float)Track_GetPeakInfo(t, 0) : 0.0f;
+        peakR[i] = t ? (float)Track_GetPeakInfo(t, 1) : 0.0f;
     }
-    
-    // Text Updates
-    if (strncmp(line1, last_line1, 63) != 0) {
-        SendLCDMessage(0x48, line1); // Top Line (Track Name)
-        strcpy(last_line1, line1);
+    MeterBankToDb(peakL, peakR, db, 8);
+
+    for (int i = 0; i < 8; i++) {
+        double shaped = m_bank_meters[i].Process(db[i], now);
+        SetMeterField(QuantizeMeterDb(shaped), i); // -60dB (0) to +6dB (127)
     }
+}
 
-    // Bottom Line Logic: Mixer vs FX
-    if (m_current_mode == MODE_FX || m_browser_mode_selection) {
-        // Use PARAM DISPLAY (0x72/0x73)
-        if (strncmp(line2_name, last_line2_name, 63) != 0) {
-            SendLCDMessage(0x72, line2_name);
-            strcpy(last_line2_name, line2_name);
-        }
-        if (strncmp(line2_val, last_line2_val, 63) != 0) {
-            SendLCDMessage(0x73, line2_val);
-            strcpy(last_line2_val, line2_val);
-        }
-    } else {
-        // MODE_MIXER: Use VOLUME TEXT (0x46) and maybe PAN TEXT (0x47)
-        // The User reported "Vol" stuck at bottom.
-        // We will send our Volume string to 0x46.
-        if (strncmp(line2_val, last_line2_val, 63) != 0) { // Using line2_val ("-inf dB")
-             SendLCDMessage(0x46, line2_val); // 0x46 = Volume Text
-             strcpy(last_line2_val, line2_val);
-             
-             // Also Clear 0x72/0x73 to prevent overlap?
-             // SendLCDMessage(0x72, "                                ");
+// GR MODE: polls the compressor at m_gr_clock.rate_hz. In FX Mode the selected
+// plugin is metered, elsewhere the first FX of the chain that reports GR.
+void CSurf_SoundFirst::UpdateGrMeter(double now) {
+    SF_API_SCOPE();
+    if (!m_gr_clock.Due(now)) return;
+
+    double gr_db = 0.0;
+    MediaTrack* tr = GetSelectedTrack(0, 0);
+    if (tr) {
+        int fx = FindGrSource(tr, (m_current_mode == MODE_FX) ? m_selected_fx_index : -1);
+        if (fx < 0 || !ReadGainReduction(tr, fx, &gr_db)) gr_db = 0.0;
+    }
+    for (int i = 1; i < DisplayModel::NUM_SLOTS; i++) SetMeterField(0, i);
+    double shaped = m_gr_meter.Process(gr_db, now);
+    SetMeterField(QuantizeMeterDb(shaped, 0.0, m_gr_range_db)); // 0 dB (0) to GrRangeDb (127)
+}
+
+// Returns the FX index to meter (only_fx, or the first reporting FX when -1), or -1. Each FX is probed at most once until
+// m_gr_sources is invalidated by a chain/selection/track list notification.
+int CSurf_SoundFirst::FindGrSource(MediaTrack* tr, int only_fx) {
+    SF_API_SCOPE();
+    if (m_gr_sources.track != tr) {
+        m_gr_sources.Invalidate();
+        m_gr_sources.track = tr;
+        m_gr_sources.fx.resize(TrackFX_GetCount(tr));
+    }
+
+    int first = 0, last = (int)m_gr_sources.fx.size() - 1;
+    if (only_fx >= 0) first = last = only_fx;
+
+    for (int i = first; i <= last; i++) {
+        if (i < 0 || i >= (int)m_gr_sources.fx.size()) return -1;
+        GrSourceCache::Entry& e = m_gr_sources.fx[i];
+        if (e.source == GrSourceCache::GR_UNKNOWN) {
+            char buf[64] = {0};
+            if (TrackFX_GetNamedConfigParm(tr, i, "GainReduction_dB", buf, sizeof(buf)) && buf[0]) {
+                e.source = GrSourceCache::GR_NATIVE;
+            } else {
+                char fxName[256] = {0};
+                TrackFX_GetFXName(tr, i, fxName, 256);
+                FXMapping* map = FXMappingRegistry::GetMapping(fxName);
+                if (map && map->meter_param_id >= 0) {
+                    e.source = GrSourceCache::GR_MAPPED;
+                    e.meter_param = map->meter_param_id;
+                    e.range_db = map->meter_range_db;
+                } else {
+                    e.source = GrSourceCache::GR_NONE;
+                }
+            }
         }
-        // Pan?
-        // SendLCDMessage(0x47, "Pan Value...");
+        if (e.source != GrSourceCache::GR_NONE) return i;
     }
+    return -1;
 }
 
+// Reduction as a positive dB amount (plugins differ in sign)
+bool CSurf_SoundFirst::ReadGainReduction(MediaTrack* tr, int fx, double* gr_db) {
+    SF_API_SCOPE();
+    if (m_gr_sources.track != tr || fx < 0 || fx >= (int)m_gr_sources.fx.size()) return false;
+    const GrSourceCache::Entry& e = m_gr_sources.fx[fx];
+    if (e.source == GrSourceCache::GR_NATIVE) {
+        char buf[64] = {0};
+        if (!TrackFX_GetNamedConfigParm(tr, fx, "GainReduction_dB", buf, sizeof(buf)) || !buf[0]) return false;
+        char* end = nullptr;
+        double v = strtod(buf, &end);
+        if (end == buf) return false;
+        *gr_db = fabs(v);
+        return true;
+    }
+    if (e.source == GrSourceCache::GR_MAPPED) {
+        *gr_db = TrackFX_GetParamNormalized(tr, fx, e.meter_param) * e.range_db;
+        return true;
+    }
+    return false;
+}
+
+// Meter (0x49) is sent only when the value the device shows changes
+void CSurf_SoundFirst::SetMeterField(int val, int slot) {
+    if (DisplayModel::Update(m_display.meter[slot], val)) SendLCDValue(0x49, val, (unsigned char)slot);
+}
@@ -8,11 +8,11 @@
 #define CSURF_SOUNDFIRST_H
 
 #include <thread>
-#include <queue>
 #include <mutex>
 #include <atomic>
 #include <map>
 #include <string>
+#include <vector>
 
 // WDL types (Required by REAPER headers)
 #ifndef WDL_INT64
@@ -59,6 +59,19 @@ typedef class ReaProject* Reaproject;
 
 #include "reaper_plugin.h"
 #include "reaper_plugin_functions.h"
+#include "display_model.h"
+#include "sysex_frame.h"
+#include "meter_engine.h"
+#include "announcer.h"
+#include "config.h"
+#include "hid_decoder.h"
+#include "tick_budget.h"
+#include "api_trace.h"
+#include "device_registry.h"
+#include "note_edit.h"
+#include "item_edit.h"
+#include "encoder_nav.h"
+#include "track_nav.h"
 
 // Helper Macros
 #ifndef MKVOL2DB
@@ -66,17 +79,31 @@ typedef class ReaProject* Reaproject;
 #define MKVOL2DB(x) ((x) <= 0.0000000298023223876953125 ? -150.0 : (20.0 * log10(x)))
 #endif
 
+// HID enumeration of the supported keyboards (one entry per interface; empty off Windows)
+void ScanSurfaceDevices(std::vector<SurfaceDevice>& out);
+
 class CSurf_SoundFirst : public IReaperControlSurface {
 public:
-    CSurf_SoundFirst(int inDev, int outDev, int outDev2);
+    // One instance per keyboard: `device` is the keyboard this surface drives (pid 0 = the
+    // first one not owned by another surface); `devices` arbitrates between instances.
+    // `config` is the INI watcher shared by all instances (nullptr: read once, no hot reload)
+    CSurf_SoundFirst(int inDev, int outDev, int outDev2, DeviceRegistry* devices = nullptr,
+                     const SurfaceDevice& device = SurfaceDevice(), ConfigWatcher* config = nullptr);
     virtual ~CSurf_SoundFirst();
 
+    static std::string ConfigPath();                       // %resource%\UserPlugins\SoundFirst_PRO.ini
+    static ConfigPtr ParseConfig(const std::string& path); // Thread-safe: file only
+
     virtual const char* GetTypeString() { return "SOUNDFIRST_A61"; }
     virtual const char* GetDescString() { return "SoundFirst PRO (Native)"; }
     virtual const char* GetConfigString();
     virtual int GetConfig(void* cfg, int cfg_sz) { return 0; }
     virtual void CloseNoReset();
     virtual int Extended(int call, void *parm1, void *parm2, void *parm3);
+    virtual void SetTrackListChange();
+    virtual void SetSurfaceSelected(MediaTrack* trackid, bool selected);
+    virtual void OnTrackSelection(MediaTrack* trackid);
+    virtual bool GetTouchState(MediaTrack* trackid, int isPan);
 
     virtual void OnMIDIEvent(MIDI_event_t* evt);
     virtual void SendMidiCC(int cc, int val);
@@ -87,12 +114,18 @@ public:
     virtual void SetSurfaceRecArm(MediaTrack* trackid, bool recarm);
     virtual void SetPlayState(bool play, bool pause, bool rec);
     virtual void SetRepeatState(bool rep);
+    virtual void SetTrackTitle(MediaTrack* trackid, const char* title);
     virtual void Run();
 
+    // Headless hosts: feed a raw HID report as if the reader thread had read it
+    void InjectHidReport(const unsigned char* report, int len);
+
     enum ControlMode { MODE_MIXER = 0, MODE_FX, MODE_MIDI, MODE_EDIT, MODE_AUDIO };
     enum SelectionMode { MODE_NORMAL, MODE_CHOOSING };
 
 private:
+    friend struct SurfaceBench;      // bench/surface_bench.cpp times the private handlers
+
     int m_midi_in_dev, m_midi_out_dev;
 
     midi_Output* m_midi_out;
@@ -109,6 +142,7 @@ private:
     double m_gr_peak_hold;
     WDL_UINT64 m_last_gr_peak_time;
     int m_loop_button_state;
+    bool m_ref_solo_active;          // Mixer QUANTIZE: reference solo on track 1 engaged
     bool m_startup_announced;
     int m_grid_index;
 
@@ -123,6 +157,33 @@ private:
     bool m_knob_touch_state[8];      // Current touch state for each knob
     int m_previous_solo_state[8];    // Solo state before touch (for restoration)
 
+    // Gesture Undo: one undo point per touch-to-release knob gesture
+    bool m_gesture_open;             // Knob writes made, undo point pending release/timeout
+    int m_gesture_undo_flags;        // UNDO_STATE_* accumulated during the gesture
+    const char* m_gesture_desc;      // Undo history label
+    unsigned int m_gesture_knobs;    // Bitmask of knobs turned inside the gesture
+    unsigned int m_gesture_pan;      // Bitmask of knobs that moved pan (Shift)
+    double m_gesture_last_move;      // time_precise() of the last knob tick
+    double m_gesture_timeout;        // Seconds of inactivity that close an untouched gesture
+
+    // Gang Mode: a Mixer knob on a selected track drives every selected track
+    bool m_gang_mode;
+    std::vector<MediaTrack*> m_selected_tracks; // Refreshed on selection notifications only
+    double m_gang_vol_db;            // Relative deltas accumulated during one queue drain
+    double m_gang_pan;
+
+    // MIDI note editing (editor open): K3-K6 deltas of one drain, applied in one pass
+    NoteEditBatch m_note_edits;
+
+    // Item editing (Audio mode, MIDI mode with the editor closed): per-gesture snapshot + totals
+    ItemEditBatch m_item_edits;
+
+    // Encoder: detents of one drain -> one cursor / loop move, scaled by spin speed
+    EncoderNav m_encoder_nav;
+
+    // Encoder up/down: pushes of one drain -> one SetOnlyTrackSelected on the cached track array
+    TrackNav m_track_nav;
+
     // Dynamic Mode System
     std::vector<std::string> m_available_modes;
     int m_current_mode_idx;
@@ -136,28 +197,56 @@ private:
     std::thread m_hid_thread;
     std::atomic<bool> m_hid_running;
     HANDLE m_hid_handle;
-    struct HidEvent { unsigned char data[64]; };
-    std::queue<HidEvent> m_hid_queue;
-    std::mutex m_hid_mutex;
-    unsigned char m_last_hid_report[64];
-    int m_last_knob_values[8];
-
-    // NHL Actions
-    std::map<std::string, std::string> m_nhl_actions;
-    std::map<int, std::map<std::string, std::string>> m_mode_actions;
+    DeviceRegistry* m_devices;       // Shared with the other surfaces (nullptr = single surface)
+    SurfaceDevice m_device;          // HID thread after construction: the claimed keyboard
+    HidDecoder m_hid_decoder;        // HID thread only
+    HidFrameQueue m_hid_frames;      // HID thread -> Run()
+    std::vector<HidFrame> m_hid_batch; // Run() only: frames of the current drain
+
+    // NHL Actions, modes and plugin sections live in the current config snapshot
+    ConfigPtr m_config;
     WDL_UINT64 m_last_button_time;
+    char m_config_string[64];        // GetConfigString() result
+    void (*m_osara_output)(const char*); // osara_outputMessage, resolved on first use
+
+    // Host Notifications (decoded in Extended(), consumed once per Run() tick)
+    enum DirtyFlag {
+        DIRTY_TRACKLIST          = 1 << 0, // Tracks added/removed/reordered
+        DIRTY_SELECTION          = 1 << 1, // Track selection changed
+        DIRTY_FX_CHAIN           = 1 << 2, // FX added/removed/reordered
+        DIRTY_FOCUSED_FX         = 1 << 3, // Plugin window focus changed
+        DIRTY_ALL                = 0x0F
+    };
+    unsigned int m_dirty;
+    MediaTrack* m_focused_fx_track;  // From CSURF_EXT_SETFOCUSEDFX
+    int m_focused_fx_index;
 
     // Hot-Reload
     std::string m_config_path;
-    WDL_UINT64 m_last_config_time;
+    ConfigWatcher* m_config_watcher; // Shared (main.cpp): parses on change, publishes snapshots
 
     // Internal Methods
     void HidThreadLoop();
+    std::string FindHidPath();       // HID thread: rescan, then the path of this surface's keyboard
+    void RunPhase(int phase, void (CSurf_SoundFirst::*fn)());
+    void ProcessInput();             // HID frames + gesture / value timeouts
+    void ReportTickBudget(double now);
     void ProcessHidQueue();
-    void HandleHidReport(unsigned char* data);
+    void ProcessDirtyFlags();
+    void HandleHidReport(const HidFrame& frame);
     void HandleEncoderRotation(int delta);
-    void HandleKnobRotation(int knob_idx, int delta);
+    void HandleKnobRotation(int knob_idx, int accel_delta);
     void HandleSpecificKnobTouch(int knob_idx, bool touch_on, bool touch_off);
+    void BeginKnobGesture(int knob_idx, int undo_flags, const char* desc, bool is_pan);
+    void EndKnobGesture();
+    void CheckKnobGestureTimeout();
+    void ToggleGangMode();
+    void RefreshSelectedTracks();
+    void ApplyGangDeltas();
+    void ApplyNoteEdits();
+    void ApplyItemEdits();
+    void ApplyEncoderNav();
+    void ApplyTrackNav();
     
     // V3 Architecture: Modular Handlers
     void HandleKnob_Mixer(int idx, int d);
@@ -172,15 +261,21 @@ private:
     void HandleReportGR(const std::string& cmd);
     void ReportTrackPeak();
     void CheckConfigHotReload();
-    void LoadMappingConfig();
+    void ApplyConfig(ConfigPtr cfg);
     void SwitchMode(ControlMode mode);
     void UpdateBankFromSelectedTrack();
     void DumpCurrentFX();
+    void DumpApiTrace();             // @DUMP_API_TRACE
     void ReportFXMetrics(MediaTrack* track, int fx_idx);
     void HandleFxParamChange(const std::string& cmd, double delta);
     void HandleFxParamSet(const std::string& cmd);
     void LogDebug(const char* text);
-    void SpeakText(const char* text);
+    void SpeakText(const char* text);                 // ANNOUNCE_STATUS
+    void Announce(int category, const char* text);    // Queued, last writer wins per category
+    void FlushAnnouncements();                        // End of Run(): at most one utterance
+    void NoteKnobValue(int src, int target, void* obj, int fx = -1, int param = -1);
+    void SpeakKnobValue(int src);
+    void CheckKnobValueRelease();
 
     void SendMidi(unsigned char status, unsigned char d1, unsigned char d2);
     void SendSysex(unsigned char* data, int length);
@@ -193,17 +288,41 @@ private:
 
     // Display & Screensaver
     void UpdateDisplay();
-    void SendLCDMessage(unsigned char cmd, const char* text);
-    void SendLCDValue(unsigned char cmd, int val); // For VuMeter
+    void RenderDisplayFields();
+    void SetMeterField(int val, int slot = 0);
+    void UpdateMeter();
+    void UpdateBankMeters(double now);
+    void UpdateGrMeter(double now);
+    int FindGrSource(MediaTrack* track, int only_fx);
+    bool ReadGainReduction(MediaTrack* track, int fx_idx, double* gr_db);
+    void SendLCDMessage(unsigned char cmd, const char* text, unsigned char idx = 0);
+    void SendLCDValue(unsigned char cmd, int val, unsigned char idx = 0); // For VuMeter
     void ResetIdleTimer();
 
+    DisplayModel m_display; // Retained LCD state (per instance, no statics)
+    AnnouncementScheduler m_announcer; // Speech queue ([ACCESSIBILITY] NavigationDwellMs, ValueDwellMs)
+    KnobValueAnnouncer m_value_announcer; // Per-knob gesture values ([ACCESSIBILITY] ValueIntervalMs)
+
     bool m_screensaver_active;
     double m_last_input_time;
     bool m_gr_meter_mode; // true = GR, false = Peak
+    MeterClock m_meter_clock;    // Fixed sampling rate ([METER] RateHz, default 30)
+    MeterBallistics m_meter;     // Attack / hold / release ([METER] AttackMs, HoldMs, ReleaseDbPerSec)
+    MeterClock m_gr_clock;       // GR polling rate ([METER] GrRateHz, default 15)
+    MeterBallistics m_gr_meter;  // GR ballistics (dB of reduction)
+    double m_gr_range_db;        // Reduction shown as full scale ([METER] GrRangeDb)
+    GrSourceCache m_gr_sources;  // FX that do / don't report GR on the selected track
+    MeterBallistics m_bank_meters[8];  // Mixer Mode: one meter per bank slot
+    MediaTrack* m_bank_tracks[8];      // Tracks of m_bank_tracks_bank (refreshed on bank/track list change)
+    int m_bank_tracks_bank;
+
+    // Run() scheduling ([PERFORMANCE] TickBudgetMs, default 1 ms)
+    TickBudget m_tick_budget;
+    double m_tick_report_time;
 
-    // SysEx Constants
-    // Header: F0 00 21 09 00 00 44 43 01 00
-    const unsigned char SYSEX_HEADER[10] = { 0xF0, 0x00, 0x21, 0x09, 0x00, 0x00, 0x44, 0x43, 0x01, 0x00 };
+    // SysEx Frames (header F0 00 21 09 00 00 44 43 01 00 written once, reused per message)
+    NhlSysexFrame<64> m_lcd_frame;  // Text: 0x46/0x48/0x72/0x73
+    NhlSysexFrame<0> m_value_frame; // Value: 0x40/0x42/0x49
 
 };
 
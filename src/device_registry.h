@@ -0,0 +1,141 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// --- DEVICE REGISTRY ---
+// One CSurf_SoundFirst per connected keyboard. The registry holds the last
+// HID scan (Native Instruments VID 17CC) and which surface owns which device,
+// keyed by PID + serial number, so a keyboard that is unplugged and plugged
+// back in returns to the same surface (and its bank / mode). Owned by main.cpp;
+// the surfaces' HID threads call Update / Claim concurrently, hence the lock.
+struct SurfaceDevice {
+    int pid = 0;              // USB product id; 0 = any supported keyboard
+    std::string serial;       // HidD_GetSerialNumberString; empty = any / not reported
+    std::string hid_path;     // DAW-control interface ("mi_02" when the device exposes several)
+    int ordinal = 0;          // Index among connected keyboards of the same model (MIDI port matching)
+
+    static bool Supported(int pid) {
+        // A-Series (1750), A49 (1740), M32 (1860), legacy A61 firmware (1620)
+        return pid == 0x1750 || pid == 0x1740 || pid == 0x1860 || pid == 0x1620;
+    }
+    static bool IsM32(int pid) { return pid == 0x1860; }
+
+    // MIDI port names carry the model letter ("Komplete Kontrol A DAW", "Komplete Kontrol M DAW")
+    const char* MidiPortTag() const { return pid == 0 ? nullptr : (IsM32(pid) ? "Kontrol M" : "Kontrol A"); }
+
+    std::string Label() const {
+        if (pid == 0) return "any";
+        char buf[96];
+        snprintf(buf, sizeof(buf), "%04X/%s", pid, serial.empty() ? "-" : serial.c_str());
+        return buf;
+    }
+
+    // Identity across reconnects: the serial when the device reports one, else the interface path
+    bool SameDevice(const SurfaceDevice& o) const {
+        if (pid != o.pid) return false;
+        if (!serial.empty() || !o.serial.empty()) return serial == o.serial;
+        return hid_path == o.hid_path;
+    }
+
+    // pid / serial left empty in a wanted spec match anything
+    bool Matches(const SurfaceDevice& want) const {
+        return (want.pid == 0 || want.pid == pid) && (want.serial.empty() || want.serial == serial);
+    }
+};
+
+class DeviceRegistry {
+public:
+    // Replaces the device list with a fresh scan (one entry per HID interface).
+    // Keeps the DAW interface per keyboard and numbers keyboards of the same model.
+    void Update(const std::vector<SurfaceDevice>& scanned) {
+        std::vector<SurfaceDevice> devices;
+        for (const SurfaceDevice& d : scanned) {
+            if (!SurfaceDevice::Supported(d.pid)) continue;
+            auto same = std::find_if(devices.begin(), devices.end(), [&](const SurfaceDevice& o) {
+                return o.pid == d.pid && !d.serial.empty() && o.serial == d.serial;
+            });
+            if (same == devices.end()) devices.push_back(d);
+            else if (IsDawInterface(d.hid_path) && !IsDawInterface(same->hid_path)) *same = d;
+        }
+        // Without a serial the interfaces of one keyboard can't be grouped: keep only the
+        // DAW interfaces of that model when it has any
+        std::vector<int> daw_pids;
+        for (const SurfaceDevice& d : devices) {
+            if (d.serial.empty() && IsDawInterface(d.hid_path)) daw_pids.push_back(d.pid);
+        }
+        devices.erase(std::remove_if(devices.begin(), devices.end(), [&](const SurfaceDevice& d) {
+            return d.serial.empty() && !IsDawInterface(d.hid_path) &&
+                   std::find(daw_pids.begin(), daw_pids.end(), d.pid) != daw_pids.end();
+        }), devices.end());
+        std::sort(devices.begin(), devices.end(), [](const SurfaceDevice& a, const SurfaceDevice& b) {
+            if (IsM32(a) != IsM32(b)) return !IsM32(a);
+            return (a.serial != b.serial) ? a.serial < b.serial : a.hid_path < b.hid_path;
+        });
+        int models[2] = { 0, 0 };
+        for (SurfaceDevice& d : devices) d.ordinal = models[IsM32(d) ? 1 : 0]++;
+
+        std::lock_guard<std::mutex> l(m_lock);
+        m_devices.swap(devices);
+    }
+
+    std::vector<SurfaceDevice> Devices() const {
+        std::lock_guard<std::mutex> l(m_lock);
+        return m_devices;
+    }
+
+    // Binds owner to a connected device matching `device` that no other surface owns,
+    // and fills in its pid / serial / path / ordinal. An owner that already holds a
+    // claim only gets that same keyboard back (it may be disconnected: returns false).
+    bool Claim(const void* owner, SurfaceDevice& device) {
+        std::lock_guard<std::mutex> l(m_lock);
+        for (const ClaimEntry& c : m_claims) {
+            if (c.owner != owner) continue;
+            for (const SurfaceDevice& d : m_devices) {
+                if (d.SameDevice(c.device)) { device = d; return true; }
+            }
+            return false;
+        }
+        for (const SurfaceDevice& d : m_devices) {
+            if (!d.Matches(device) || OwnedByOther(owner, d)) continue;
+            m_claims.push_back({ owner, d });
+            device = d;
+            return true;
+        }
+        return false;
+    }
+
+    void Release(const void* owner) {
+        std::lock_guard<std::mutex> l(m_lock);
+        m_claims.erase(std::remove_if(m_claims.begin(), m_claims.end(),
+            [&](const ClaimEntry& c) { return c.owner == owner; }), m_claims.end());
+    }
+
+private:
+    struct ClaimEntry {
+        const void* owner;
+        SurfaceDevice device;
+    };
+
+    mutable std::mutex m_lock;
+    std::vector<SurfaceDevice> m_devices;
+    std::vector<ClaimEntry> m_claims;
+
+    static bool IsM32(const SurfaceDevice& d) { return SurfaceDevice::IsM32(d.pid); }
+
+    static bool IsDawInterface(const std::string& path) {
+        std::string p = path;
+        std::transform(p.begin(), p.end(), p.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+        return p.find("mi_02") != std::string::npos;
+    }
+
+    bool OwnedByOther(const void* owner, const SurfaceDevice& d) const {
+        for (const ClaimEntry& c : m_claims) {
+            if (c.owner != owner && c.device.SameDevice(d)) return true;
+        }
+        return false;
+    }
+};
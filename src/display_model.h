@@ -0,0 +1,71 @@
+#pragma once
+#include <cstring>
+
+// Retained LCD state for ONE keyboard (lives inside its surface instance).
+// A field is re-rendered only when its dirty bit is set by a state-change event,
+// and re-sent only when the rendered text differs from what the device shows.
+struct DisplayModel {
+    enum Field {
+        FIELD_MODE        = 1 << 0, // CC 5 (0=Mixer layout, 1=Plugin layout)
+        FIELD_TRACK_STATE = 1 << 1, // 0x40 / 0x42 (track available / selected)
+        FIELD_TRACK_LINE  = 1 << 2, // 0x48 top line
+        FIELD_VOLUME      = 1 << 3, // 0x46 volume text (Mixer layout)
+        FIELD_METER       = 1 << 4, // 0x49 (one value per slot)
+        FIELD_ALL         = 0x1F
+    };
+    static const int NUM_SLOTS = 8;
+    static const unsigned int ALL_SLOTS = 0xFF;
+
+    unsigned int dirty;            // Field bits
+    unsigned int slot_name_dirty;  // One bit per knob slot (0x72)
+    unsigned int slot_value_dirty; // One bit per knob slot (0x73)
+
+    // What the device currently shows (-1 / "" = unknown, forces a send)
+    int mode;
+    int track_state;
+    int meter[NUM_SLOTS];
+    char track_line[64];
+    char volume_text[64];
+    char slot_name[NUM_SLOTS][64];
+    char slot_value[NUM_SLOTS][64];
+
+    // Surface state the text was rendered from
+    void* track;         // MediaTrack* shown on the top line (host callbacks compare against it)
+    int key_mode;        // ControlMode
+    int key_fx_index;
+    int key_fx_page;
+    int key_mode_idx;    // BROWSER selection cursor
+    bool key_browser;
+    bool screensaver;
+
+    DisplayModel() { Reset(); }
+
+    // Device contents unknown (startup / wake): everything is resent
+    void Reset() {
+        mode = -1; track_state = -1;
+        track_line[0] = 0; volume_text[0] = 0;
+        for (int i = 0; i < NUM_SLOTS; i++) { slot_name[i][0] = 0; slot_value[i][0] = 0; meter[i] = -1; }
+        track = nullptr;
+        key_mode = -1; key_fx_index = -1; key_fx_page = -1; key_mode_idx = -1;
+        key_browser = false; screensaver = false;
+        InvalidateAll();
+    }
+
+    void Invalidate(unsigned int fields) { dirty |= fields; }
+    void InvalidateSlots(unsigned int names, unsigned int values) { slot_name_dirty |= names; slot_value_dirty |= values; }
+    void InvalidateAll() { dirty = FIELD_ALL; slot_name_dirty = ALL_SLOTS; slot_value_dirty = ALL_SLOTS; }
+    bool IsDirty() const { return dirty || slot_name_dirty || slot_value_dirty; }
+
+    // Stores the new content; true when it differs from the device (caller sends it)
+    static bool Update(char* shown, const char* text) {
+        if (strncmp(shown, text, 63) == 0) return false;
+        size_t n = strnlen(text, 63);
+        memcpy(shown, text, n); shown[n] = 0;
+        return true;
+    }
+    static bool Update(int& shown, int value) {
+        if (shown == value) return false;
+        shown = value;
+        return true;
+    }
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include <cmath>
+#include <cstdlib>
+
+// --- ENCODER NAVIGATION ---
+// Encoder turns move the edit cursor (Shift in Mixer: the loop) by beats, bars or sections by spin speed.
+struct EncoderNav {
+    enum Target { TARGET_CURSOR = 0, TARGET_LOOP };
+    enum Unit { UNIT_BEAT = 0, UNIT_BAR, UNIT_SECTION };
+
+    double bar_rate = 12.0;       // Detents per second from which a detent moves one bar ([ENCODER] BarRate)
+    double section_rate = 30.0;   // ... one section ([ENCODER] SectionRate)
+    int bars_per_section = 4;     // [ENCODER] BarsPerSection
+
+    int pending = 0;              // Detents of this drain
+    int target = TARGET_CURSOR;
+    double last_time = -1.0;      // Last drain that moved
+
+    void Add(int d, int t) {
+        if (t != target) { target = t; pending = 0; } // Shift flipped mid-drain: the new target only
+        pending += d;
+    }
+
+    // Speed of this drain (detents / s, gaps over 250 ms restart at rest) -> unit; clears pending
+    int TakeUnit(double now) {
+        double dt = (last_time < 0.0) ? 0.25 : now - last_time;
+        if (dt < 1.0 / 30.0) dt = 1.0 / 30.0; else if (dt > 0.25) dt = 0.25;
+        double rate = std::abs(pending) / dt;
+        last_time = now;
+        pending = 0;
+        if (rate >= section_rate) return UNIT_SECTION;
+        if (rate >= bar_rate) return UNIT_BAR;
+        return UNIT_BEAT;
+    }
+
+    // pos in grid units (beats, or bars with the fraction of the bar); unit = cell size in
+    // those units. Forward goes to the next cell boundary, back to the current cell's start
+    // first, as the "move one beat" actions do. Returns the target boundary, never below 0.
+    static double Step(double pos, int unit, int steps) {
+        const double eps = 1e-6;
+        double cell = std::floor(pos / unit + eps);
+        bool on_grid = std::fabs(pos - cell * unit) < eps;
+        double to = (steps > 0 || on_grid) ? cell + steps : cell + steps + 1;
+        if (to < 0.0) to = 0.0;
+        return to * unit;
+    }
+};
@@ -1,7 +1,48 @@
 #pragma once
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <unordered_set>
 #include <vector>
 #include <map>
+#include "ini_parser.h"
+#include "logger.h"
+
+// Button IDs (NHL Command IDs). Index into FXMapping::buttons.
+enum MappableButton {
+    BTN_LOOP=0, BTN_METRO, BTN_TEMPO, 
+    BTN_IDEAS, BTN_QUANTIZE, BTN_AUTO,
+    BTN_MUTE, BTN_SOLO,
+    BTN_UNDO, // Mappable in files, but RunNhlAction keeps Undo hardcoded
+    BTN_PRESET_UP, BTN_PRESET_DOWN,
+    BTN_PLAY, BTN_STOP, BTN_REC, BTN_ENC_PRESS,
+    NUM_MAPPABLE_BUTTONS
+};
+
+// NHL key name -> MappableButton, -1 if the key is not mappable (case-insensitive)
+inline int MappableButtonFromKey(std::string_view key) {
+    static const struct { const char* key; int id; } kButtons[] = {
+        { "LOOP", BTN_LOOP }, { "METRO", BTN_METRO }, { "TEMPO", BTN_TEMPO }, { "IDEAS", BTN_IDEAS },
+        { "QUANTIZE", BTN_QUANTIZE }, { "AUTO", BTN_AUTO }, { "MUTE", BTN_MUTE }, { "SOLO", BTN_SOLO },
+        { "UNDO", BTN_UNDO }, { "PRESET_UP", BTN_PRESET_UP }, { "PRESET_DOWN", BTN_PRESET_DOWN },
+        { "PLAY", BTN_PLAY }, { "STOP", BTN_STOP }, { "REC", BTN_REC }, { "ENC_PRESS", BTN_ENC_PRESS } };
+    for (const auto& b : kButtons) {
+        if (IniEqualsNoCase(key, b.key)) return b.id;
+    }
+    return -1;
+}
+
+// Page names and button actions repeat across hundreds of mappings ("Main",
+// "40044"...): each distinct string is stored once and never freed, so the
+// mapping structs hold plain const char* and copy without allocating.
+// Called from the config watcher thread as well, hence the lock.
+inline const char* InternString(std::string_view s) {
+    static std::unordered_set<std::string> pool;
+    static std::mutex lock;
+    std::lock_guard<std::mutex> guard(lock);
+    return pool.emplace(s).first->c_str();
+}
 
 struct FXKnobMap {
     int param_id = -1;       // The parameter to control
@@ -11,33 +52,32 @@ struct FXKnobMap {
 };
 
 struct FXPage {
-    std::string name;
+    const char* name = "";   // Interned (or a literal for factory pages)
     FXKnobMap knobs[8]; // 8 Knobs
 };
 
 struct FXMapping {
     std::string plugin_name_signature; // e.g. "Lindell 50"
     std::vector<FXPage> pages; 
-    std::map<unsigned char, std::string> buttons; // Key: Button ID (e.g. 0x01 Loop), Value: Action String (e.g. "12" or "@REPORT_PEAK")
+    const char* buttons[NUM_MAPPABLE_BUTTONS] = {}; // Interned action string (e.g. "12" or "@REPORT_PEAK"), nullptr = not mapped
+    int meter_param_id = -1;        // GR meter source for plugins without native GainReduction_dB
+    double meter_range_db = 20.0;   // Normalized 1.0 of the meter param = this much reduction
 };
 
-// Button IDs (NHL Command IDs)
-enum MappableButton {
-    BTN_LOOP=0, BTN_METRO, BTN_TEMPO, 
-    BTN_IDEAS, BTN_QUANTIZE, BTN_AUTO,
-    BTN_MUTE, BTN_SOLO
-    // UNDO Removed
-};
+// Plugin sections of SoundFirst_PRO.ini ("[VST3: Foo]" with Knob1=, Touch1=, PLAY=...),
+// keyed by section name. Loaded into the same FXMapping shape as the map files.
+typedef std::map<std::string, FXMapping> FXMappingTable;
 
 // Global Registry
 class FXMappingRegistry {
 public:
     static FXMapping* GetMapping(const char* fx_name) {
-        static std::map<std::string, FXMapping*> cache;
+        std::map<std::string, FXMapping*>& cache = Cache();
         std::string sName = fx_name;
         
         // 1. Check Cache
-        if (cache.count(sName)) return cache[sName];
+        auto cached = cache.find(sName);
+        if (cached != cache.end()) return cached->second;
         
         // 2. Try Loading from File (Highest Priority: User Overrides)
         FXMapping* fileMap = LoadMappingFromFile(sName);
@@ -65,6 +105,17 @@ public:
              }
         }
 
+        // 2c. Plugin sections of SoundFirst_PRO.ini (exact section name, then simplified)
+        if (const FXMappingTable* sections = Sections().get()) {
+            auto it = sections->find(sName);
+            if (it == sections->end() && !simpleName.empty()) it = sections->find(simpleName);
+            if (it != sections->end()) {
+                FXMapping* copy = new FXMapping(it->second);
+                cache[sName] = copy;
+                return copy;
+            }
+        }
+
         // 3. Fallback to Factory Defaults (Hardcoded)
         static std::vector<FXMapping> factory_mappings;
         if (factory_mappings.empty()) InitializeMappings(factory_mappings);
@@ -83,7 +134,28 @@ public:
         return nullptr;
     }
 
+    // New config snapshot (main thread): swaps in its plugin sections and drops
+    // the cache, so edited sections and map files are picked up on the next lookup.
+    // Pointers returned by GetMapping are only valid until then. The table already
+    // installed (another surface adopted the same snapshot) is a no-op.
+    static void SetConfigMappings(std::shared_ptr<const FXMappingTable> sections) {
+        if (sections && Sections() == sections) return;
+        Sections() = std::move(sections);
+        for (auto& entry : Cache()) delete entry.second;
+        Cache().clear();
+    }
+
 private:
+    static std::map<std::string, FXMapping*>& Cache() {
+        static std::map<std::string, FXMapping*> cache;
+        return cache;
+    }
+
+    static std::shared_ptr<const FXMappingTable>& Sections() {
+        static std::shared_ptr<const FXMappingTable> sections;
+        return sections;
+    }
+
     // Helper: Sanitize plugin name for filename
     static std::string SanitizeName(std::string name) {
         // Simple sanitization: Keep alphanumeric, spaces, dashes suitable for filename
@@ -130,102 +202,61 @@ private:
         return name.substr(first, (last - first + 1));
     }
 
-    static std::string ToUpper(std::string s) {
-        std::transform(s.begin(), s.end(), s.begin(), ::toupper);
-        return s;
-    }
-
     static FXMapping* LoadMappingFromFile(const std::string& fx_name) {
         char* appData = getenv("APPDATA");
         if (!appData) return nullptr;
         
         std::string sName = SanitizeName(fx_name);
-        char path[1024]; sprintf(path, "%s\\REAPER\\UserPlugins\\SoundFirst_Maps\\%s.ini", appData, sName.c_str());
+        char path[1024]; snprintf(path, sizeof(path), "%s\\REAPER\\UserPlugins\\SoundFirst_Maps\\%s.ini", appData, sName.c_str());
         
-        std::ifstream f(path);
-        if (!f.is_open()) return nullptr;
+        IniFile ini;
+        if (!ini.Load(path)) return nullptr;
         
         FXMapping* map = new FXMapping(); 
         map->plugin_name_signature = fx_name; 
         
-        std::string line, section;
-        while (std::getline(f, line)) {
-            // Trim
-            size_t first = line.find_first_not_of(" \t\r\n");
-            if (std::string::npos == first) continue;
-            size_t last = line.find_last_not_of(" \t\r\n");
-            line = line.substr(first, (last - first + 1));
-            
-            if (line.empty() || line[0] == ';') continue;
-            
-            if (line[0] == '[') {
-                section = line.substr(1, line.find(']') - 1);
-                // Create page if new PageX section
-                if (section.find("Page") == 0) {
-                     try {
-                         int idx = std::stoi(section.substr(4));
-                         if (idx > 0) {
-                             while (map->pages.size() < (size_t)idx) map->pages.push_back(FXPage());
-                         }
-                     } catch(...) {}
-                }
-                continue;
-            }
-            
-            size_t eq = line.find('=');
-            if (eq == std::string::npos) continue;
-            std::string k_raw = line.substr(0, eq);
-            std::string v = line.substr(eq+1);
-            
-            std::string k = ToUpper(k_raw); // Case-insensitive key
-            
-            if (section.find("Page") == 0) {
-                int p_idx = std::stoi(section.substr(4)) - 1;
-                if (p_idx < 0 || p_idx >= map->pages.size()) continue;
-                
-                FXPage& page = map->pages[p_idx];
+        // Keys are case-insensitive; [PageN] sections create pages 1..N on first use
+        ini.ForEach([&](std::string_view section, std::string_view k, std::string_view v, int line) {
+            if (IniStartsWith(section, "Page")) {
+                int page_no = 0;
+                if (!IniParseInt(section.substr(4), page_no) || page_no <= 0) { ini.AddError(line, "invalid page section"); return; }
+                while (map->pages.size() < (size_t)page_no) map->pages.push_back(FXPage());
+                FXPage& page = map->pages[page_no - 1];
                 
-                if (k == "NAME") page.name = v;
-                else if (k[0] == 'K') {
+                if (IniEqualsNoCase(k, "NAME")) page.name = InternString(v);
+                else if (!k.empty() && IniUpper(k[0]) == 'K') {
                     // K1, K1_SHIFT, K1_TOUCH
-                    int k_idx = -1;
-                    try {
-                        size_t underscore = k.find("_");
-                        if (underscore != std::string::npos) {
-                            k_idx = std::stoi(k.substr(1, underscore - 1)) - 1;
-                        } else {
-                            k_idx = std::stoi(k.substr(1)) - 1;
-                        }
-                    } catch(...) {}
-                    
-                    if (k_idx >= 0 && k_idx < 8) {
-                        int param_id = std::stoi(v);
-                        if (k.find("_SHIFT") != std::string::npos) page.knobs[k_idx].shift_param_id = param_id;
-                        else if (k.find("_TOUCH") != std::string::npos) page.knobs[k_idx].touch_param_id = param_id;
-                        else page.knobs[k_idx].param_id = param_id;
-                    }
+                    int k_idx = 0;
+                    size_t underscore = k.find('_');
+                    if (!IniParseInt(k.substr(1, underscore == std::string_view::npos ? std::string_view::npos : underscore - 1), k_idx)) return;
+                    k_idx -= 1;
+                    if (k_idx < 0 || k_idx >= 8) return;
+
+                    int param_id = -1;
+                    if (!IniParseInt(v, param_id)) { ini.AddError(line, "invalid parameter id"); return; }
+                    if (IniFindNoCase(k, "_SHIFT") != std::string_view::npos) page.knobs[k_idx].shift_param_id = param_id;
+                    else if (IniFindNoCase(k, "_TOUCH") != std::string_view::npos) page.knobs[k_idx].touch_param_id = param_id;
+                    else page.knobs[k_idx].param_id = param_id;
                 }
             }
             else if (section == "Buttons") {
-                int btn_id = -1;
-                if (k == "LOOP") btn_id = BTN_LOOP;
-                else if (k == "METRO") btn_id = BTN_METRO;
-                else if (k == "TEMPO") btn_id = BTN_TEMPO;
-                else if (k == "IDEAS") btn_id = BTN_IDEAS;
-                else if (k == "QUANTIZE") btn_id = BTN_QUANTIZE;
-                else if (k == "AUTO") btn_id = BTN_AUTO;
-                else if (k == "MUTE") btn_id = BTN_MUTE;
-                else if (k == "SOLO") btn_id = BTN_SOLO;
-                
-                if (btn_id != -1) {
-                    map->buttons[btn_id] = v;
-                }
+                int btn = MappableButtonFromKey(k);
+                if (btn >= 0) map->buttons[btn] = InternString(v);
             }
             else if (section == "Main") {
-                if (k == "PLUGINNAME") {
-                    map->plugin_name_signature = v;
+                // PluginName=... ; MeterParam=7 ; MeterRangeDb=20
+                if (IniEqualsNoCase(k, "PLUGINNAME")) map->plugin_name_signature = std::string(v);
+                else if (IniEqualsNoCase(k, "METERPARAM")) {
+                    if (!IniParseInt(v, map->meter_param_id)) ini.AddError(line, "invalid MeterParam");
+                }
+                else if (IniEqualsNoCase(k, "METERRANGEDB")) {
+                    if (!IniParseDouble(v, map->meter_range_db)) ini.AddError(line, "invalid MeterRangeDb");
                 }
             }
+        });
+
+        for (const IniError& e : ini.Errors()) {
+            SF_LOG(LOG_WARN, LOGCAT_CONFIG, "%s:%d: %s", path, e.line, e.message);
         }
         return map;
     }
@@ -357,6 +388,7 @@ private:
             p1.knobs[6] = { 9 };     // Trim
             p1.knobs[7] = { 7 };     // Meter
             map.pages.push_back(p1);
+            map.meter_param_id = 7;  // No native GainReduction_dB
             m.push_back(map);
         }
 
@@ -0,0 +1,147 @@
+#pragma once
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include "logger.h"
+
+// One decoded unit of keyboard input, built on the HID thread.
+// Everything that needs only the report bytes is done here (edge detection,
+// encoder/knob wrap-around, acceleration, fixed transport commands); Run()
+// only resolves what depends on REAPER state and makes the API calls.
+struct HidFrame {
+    static const int EDGE_BYTES = 6;   // Buttons, transport, nav, touch (bytes 0..5)
+    static const int MAX_COMMANDS = 4;
+
+    unsigned char data[64];            // Newest report (levels: Shift, touch state...)
+    unsigned char pressed[EDGE_BYTES]; // Bits that went 0 -> 1 in this frame
+    unsigned char released[EDGE_BYTES];
+    int encoder_delta;                 // Byte 28 counter, wrap-corrected
+    int knob_delta[8];                 // Accelerated, Mixer/MIDI/Audio curve
+    int knob_delta_fx[8];              // Accelerated, gentler FX curve
+    int commands[MAX_COMMANDS];        // Main_OnCommand IDs resolved from fixed buttons
+    int num_commands;
+    int reports;                       // HID reports merged into this frame
+
+    // Level of a button byte before this frame
+    unsigned char Previous(int byte) const { return data[byte] ^ (pressed[byte] | released[byte]); }
+
+    bool HasEdges() const {
+        for (int i = 0; i < EDGE_BYTES; i++) if (pressed[i] || released[i]) return true;
+        return num_commands > 0;
+    }
+};
+
+// Knob acceleration (V1.0). Applied per report, before coalescing, so a fast
+// spin split over several frames accelerates exactly as it did report by report.
+// Small turns (d=1,2,3) stay 1, 2, 3 (precision); faster turns are boosted.
+inline int AccelerateKnob(int d, bool fx_curve) {
+    int ad = abs(d);
+    if (fx_curve) return (ad > 4) ? d * (1 + (ad / 8)) : d; // GENTLER curve for FX (params 0.0-1.0)
+    return (ad > 3) ? d * (1 + (ad / 4)) : d;               // AGGRESSIVE curve for faders
+}
+
+// Report -> frame. Owned by the HID thread (no locking, no REAPER calls).
+class HidDecoder {
+public:
+    HidDecoder() { Reset(); }
+
+    // Device (re)connected: the next report is a baseline, not a move
+    void Reset() {
+        memset(m_last, 0, sizeof(m_last));
+        for (int i = 0; i < 8; i++) m_last_knob[i] = -1;
+    }
+
+    void Decode(const unsigned char* report, HidFrame& f) {
+        memset(&f, 0, sizeof(f));
+        memcpy(f.data, report, 64);
+        f.reports = 1;
+        const unsigned char* data = report;
+        const unsigned char* old = m_last;
+
+        if (SF_LOG_ON(LOG_TRACE, LOGCAT_HID) && memcmp(data, old, 64) != 0) {
+            SF_LOG(LOG_TRACE, LOGCAT_HID, "[A61_TRUTH] %02X %02X %02X %02X %02X %02X %02X %02X",
+                   data[0], data[1], data[2], data[3], data[4], data[5], data[6], data[7]);
+        }
+        if (data[3] != old[3]) SF_LOG(LOG_DEBUG, LOGCAT_HID, "Byte 3 Change: %02X (Was %02X)", data[3], old[3]);
+
+        for (int i = 0; i < HidFrame::EDGE_BYTES; i++) {
+            f.pressed[i] = data[i] & ~old[i];
+            f.released[i] = old[i] & ~data[i];
+        }
+
+        // Fixed transport buttons: same command in every mode, resolved here
+        bool isShift = (data[1] & 0x01) != 0;
+        if (f.pressed[1] & 0x08) { AddCommand(f, isShift ? 40030 : 40029); f.pressed[1] &= ~0x08; } // REDO / UNDO
+        if (f.pressed[2] & 0x02) { AddCommand(f, isShift ? 40042 : 40073); f.pressed[2] &= ~0x02; } // PLAY: Go to start / Play-Pause
+        if ((f.pressed[2] & 0x04) && !isShift) { AddCommand(f, 1013); f.pressed[2] &= ~0x04; }      // REC (Shift+REC stays: AUTO)
+        if (f.pressed[2] & 0x08) { AddCommand(f, 1016); f.pressed[2] &= ~0x08; }                    // STOP
+
+        // Byte 28: Encoder Turn (Continuous Counter)
+        if (data[28] != old[28]) {
+            int delta = (int)((signed char)data[28] - (signed char)old[28]);
+            if (delta > 128) delta -= 256;
+            else if (delta < -128) delta += 256;
+            f.encoder_delta = delta;
+        }
+
+        // Bytes 6-21: Knobs (10-bit counters)
+        for (int i = 0; i < 8; i++) {
+            int b = 6 + (i * 2);
+            int val = data[b] | (data[b+1] << 8);
+            if (m_last_knob[i] != -1 && val != m_last_knob[i]) {
+                int d = val - m_last_knob[i];
+                if (d > 512) d -= 1024; else if (d < -512) d += 1024;
+                if (abs(d) < 200) {
+                    f.knob_delta[i] = AccelerateKnob(d, false);
+                    f.knob_delta_fx[i] = AccelerateKnob(d, true);
+                }
+            }
+            m_last_knob[i] = val;
+        }
+
+        memcpy(m_last, data, 64);
+    }
+
+private:
+    unsigned char m_last[64];
+    int m_last_knob[8];
+
+    static void AddCommand(HidFrame& f, int cmd) {
+        if (f.num_commands < HidFrame::MAX_COMMANDS) f.commands[f.num_commands++] = cmd;
+    }
+};
+
+// HID thread -> Run() hand-off. Frames without edges (pure knob/encoder motion)
+// merge into a motion-only tail, so a stalled UI thread finds one summed frame
+// instead of hundreds of reports. The consumer swaps the whole batch out under
+// the lock and processes it unlocked.
+class HidFrameQueue {
+public:
+    void Push(const HidFrame& f) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_frames.empty() && !f.HasEdges() && !m_frames.back().HasEdges()) {
+            HidFrame& tail = m_frames.back();
+            memcpy(tail.data, f.data, sizeof(tail.data));
+            tail.encoder_delta += f.encoder_delta;
+            for (int i = 0; i < 8; i++) {
+                tail.knob_delta[i] += f.knob_delta[i];
+                tail.knob_delta_fx[i] += f.knob_delta_fx[i];
+            }
+            tail.reports += f.reports;
+            return;
+        }
+        m_frames.push_back(f);
+    }
+
+    // out is cleared and receives every pending frame in order
+    void Drain(std::vector<HidFrame>& out) {
+        out.clear();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_frames.swap(out);
+    }
+
+private:
+    std::mutex m_mutex;
+    std::vector<HidFrame> m_frames;
+};
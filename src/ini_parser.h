@@ -0,0 +1,123 @@
+#pragma once
+#include <charconv>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// --- INI PARSER (shared by SoundFirst_PRO.ini and SoundFirst_Maps\*.ini) ---
+// The file is read with ONE fread into one buffer; sections, keys and values
+// are string_views into that buffer (no per-line std::string, no substr, no
+// upper-case copies). Numbers are parsed with from_chars, never by exception.
+// Malformed lines and bad values are collected with their line numbers.
+// Requires C++17.
+
+struct IniError {
+    int line;
+    std::string message;
+};
+
+inline std::string_view IniTrim(std::string_view s) {
+    size_t b = 0, e = s.size();
+    while (b < e && (s[b] == ' ' || s[b] == '\t' || s[b] == '\r' || s[b] == '\n')) b++;
+    while (e > b && (s[e - 1] == ' ' || s[e - 1] == '\t' || s[e - 1] == '\r' || s[e - 1] == '\n')) e--;
+    return s.substr(b, e - b);
+}
+
+inline char IniUpper(char c) { return (c >= 'a' && c <= 'z') ? (char)(c - 32) : c; }
+
+// ASCII case-insensitive helpers (keys of mapping files are case-insensitive)
+inline bool IniEqualsNoCase(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) if (IniUpper(a[i]) != IniUpper(b[i])) return false;
+    return true;
+}
+
+inline bool IniStartsWith(std::string_view s, std::string_view prefix) {
+    return s.size() >= prefix.size() && s.compare(0, prefix.size(), prefix) == 0;
+}
+
+inline size_t IniFindNoCase(std::string_view s, std::string_view needle) {
+    if (needle.size() > s.size()) return std::string_view::npos;
+    for (size_t i = 0; i + needle.size() <= s.size(); i++) {
+        if (IniEqualsNoCase(s.substr(i, needle.size()), needle)) return i;
+    }
+    return std::string_view::npos;
+}
+
+// Leading number like std::stoi ("7 ; comment" -> 7); false when there is none
+inline bool IniParseInt(std::string_view v, int& out) {
+    v = IniTrim(v);
+    if (!v.empty() && v[0] == '+') v.remove_prefix(1);
+    auto r = std::from_chars(v.data(), v.data() + v.size(), out);
+    return r.ec == std::errc();
+}
+
+inline bool IniParseDouble(std::string_view v, double& out) {
+    v = IniTrim(v);
+    if (!v.empty() && v[0] == '+') v.remove_prefix(1);
+    auto r = std::from_chars(v.data(), v.data() + v.size(), out);
+    return r.ec == std::errc();
+}
+
+class IniFile {
+public:
+    // Whole file in one read; false if it cannot be opened
+    bool Load(const char* path) {
+        m_text.clear();
+        m_errors.clear();
+        FILE* f = fopen(path, "rb");
+        if (!f) return false;
+        fseek(f, 0, SEEK_END);
+        long size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+        if (size > 0) {
+            m_text.resize((size_t)size);
+            m_text.resize(fread(&m_text[0], 1, (size_t)size, f));
+        }
+        fclose(f);
+        return true;
+    }
+
+    // In-memory source (generated files, benchmarks)
+    void LoadFromString(std::string text) {
+        m_text = std::move(text);
+        m_errors.clear();
+    }
+
+    // fn(section, key, value, line) for every key=value line, in file order.
+    // Sections: [Name] (trimmed). Comments: lines starting with ';' or '#'.
+    template <typename Fn>
+    void ForEach(Fn&& fn) {
+        std::string_view text(m_text);
+        std::string_view section;
+        int line_no = 0;
+        size_t pos = 0;
+        while (pos < text.size()) {
+            size_t nl = text.find('\n', pos);
+            if (nl == std::string_view::npos) nl = text.size();
+            std::string_view line = IniTrim(text.substr(pos, nl - pos));
+            pos = nl + 1;
+            line_no++;
+
+            if (line.empty() || line[0] == ';' || line[0] == '#') continue;
+            if (line[0] == '[') {
+                size_t close = line.find(']');
+                if (close == std::string_view::npos) { AddError(line_no, "unterminated section header"); continue; }
+                section = IniTrim(line.substr(1, close - 1));
+                continue;
+            }
+            size_t eq = line.find('=');
+            if (eq == std::string_view::npos) { AddError(line_no, "expected key=value"); continue; }
+            fn(section, IniTrim(line.substr(0, eq)), IniTrim(line.substr(eq + 1)), line_no);
+        }
+    }
+
+    // Callers report bad values through here so all problems share one list
+    void AddError(int line, const char* message) { m_errors.push_back({ line, message }); }
+    const std::vector<IniError>& Errors() const { return m_errors; }
+
+private:
+    std::string m_text;              // Owns the bytes every string_view points into
+    std::vector<IniError> m_errors;
+};
@@ -0,0 +1,64 @@
+#pragma once
+#include <vector>
+
+class MediaItem;
+class MediaItem_Take;
+
+// --- ITEM EDIT BATCH ---
+// Audio mode: K2 move, K3/K4 trim, K6/K7 fades, as seconds added to a per-gesture snapshot.
+struct ItemEditBatch {
+    enum Kind { ITEM_MOVE = 0, ITEM_TRIM_START, ITEM_TRIM_END, ITEM_FADE_IN, ITEM_FADE_OUT, NUM_KINDS };
+
+    struct Item {
+        MediaItem* item;
+        MediaItem_Take* take;     // Active take (nullptr for empty items): D_STARTOFFS follows trim start
+        double position, length, fade_in, fade_out;
+        double start_offset, playrate;
+    };
+
+    double seconds_per_count = 0.01;  // [AUDIO] ItemStepMs / 1000; Shift = 1/10
+    std::vector<Item> items;          // Selected items when the gesture started
+    bool snapshot_taken = false;      // False: the next apply takes the snapshot
+    double total[NUM_KINDS] = {};     // Seconds since the snapshot
+    bool pending = false;             // total changed since the last apply
+    int last_knob = -1;               // For the value announcement
+    int last_kind = -1;
+
+    void Add(int kind, int knob, int d, bool shift) {
+        if (d == 0) return;
+        total[kind] += d * seconds_per_count * (shift ? 0.1 : 1.0);
+        pending = true;
+        last_knob = knob;
+        last_kind = kind;
+    }
+
+    // Gesture over: the next edit starts from a fresh snapshot of the selection
+    void EndGesture() {
+        items.clear();
+        snapshot_taken = false;
+        for (int i = 0; i < NUM_KINDS; i++) total[i] = 0.0;
+        pending = false;
+    }
+
+    // Snapshot + totals for one item. Trim start moves the left edge (position,
+    // length and take offset together); lengths never drop below min_len and
+    // fades never exceed the item.
+    void Compute(const Item& s, double& position, double& length, double& fade_in, double& fade_out,
+                 double& start_offset) const {
+        const double min_len = 0.001;
+        double trim = total[ITEM_TRIM_START];
+        if (s.position + total[ITEM_MOVE] + trim < 0.0) trim = -(s.position + total[ITEM_MOVE]);
+        if (s.length - trim < min_len) trim = s.length - min_len;
+
+        position = s.position + total[ITEM_MOVE] + trim;
+        if (position < 0.0) position = 0.0;
+        length = s.length - trim + total[ITEM_TRIM_END];
+        if (length < min_len) length = min_len;
+        start_offset = s.start_offset + trim * s.playrate;
+
+        fade_in = s.fade_in + total[ITEM_FADE_IN];
+        if (fade_in < 0.0) fade_in = 0.0; else if (fade_in > length) fade_in = length;
+        fade_out = s.fade_out + total[ITEM_FADE_OUT];
+        if (fade_out < 0.0) fade_out = 0.0; else if (fade_out > length) fade_out = length;
+    }
+};
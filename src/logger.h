@@ -0,0 +1,418 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+// --- ASYNC LOGGER ---
+// Producers (REAPER main thread, HID thread, DLL entry) copy one record into a
+// slot of a lock-free bounded multi-producer ring and return. Records made by
+// SF_LOG carry the format literal and raw arguments; printf runs on the flusher. A background
+// flusher drains the ring in batches through ONE persistent file handle, with
+// size-based rotation (SoundFirst_Logs.txt -> SoundFirst_Logs.1.txt).
+// No file-system syscalls happen on the caller's thread.
+
+enum LogLevel { LOG_ERROR = 0, LOG_WARN, LOG_INFO, LOG_DEBUG, LOG_TRACE };
+
+enum LogCategory {
+    LOGCAT_HID      = 1 << 0, // Raw reports, device scan
+    LOGCAT_DISPATCH = 1 << 1, // Actions, NHL commands
+    LOGCAT_DISPLAY  = 1 << 2, // LCD / meter traffic
+    LOGCAT_CONFIG   = 1 << 3, // INI loading, hot reload
+    LOGCAT_GENERAL  = 1 << 4, // Lifecycle (LogDebug / RawLog)
+    LOGCAT_ALL      = 0x1F
+};
+
+// Compile-time ceiling. Anything above it (or outside the category mask) is
+// removed by the compiler together with its argument expressions.
+// Release builds keep DEBUG and drop the HID category (per-report dumps);
+// override with -DSOUNDFIRST_LOG_MAX_LEVEL=... / -DSOUNDFIRST_LOG_CATEGORIES=...
+#ifndef SOUNDFIRST_LOG_MAX_LEVEL
+#ifdef NDEBUG
+#define SOUNDFIRST_LOG_MAX_LEVEL 3 // LOG_DEBUG
+#else
+#define SOUNDFIRST_LOG_MAX_LEVEL 4 // LOG_TRACE
+#endif
+#endif
+
+#ifndef SOUNDFIRST_LOG_CATEGORIES
+#ifdef NDEBUG
+#define SOUNDFIRST_LOG_CATEGORIES 0x1E // All but LOGCAT_HID
+#else
+#define SOUNDFIRST_LOG_CATEGORIES 0x1F
+#endif
+#endif
+
+template <int LEVEL, int CATEGORY>
+struct LogCompiled {
+    static const bool value = (LEVEL <= SOUNDFIRST_LOG_MAX_LEVEL) && ((CATEGORY & SOUNDFIRST_LOG_CATEGORIES) != 0);
+};
+
+// Raw argument captured by the producer; the flusher does the printf work
+struct LogArg {
+    enum Type : unsigned char { ARG_INT, ARG_UINT, ARG_DOUBLE, ARG_PTR, ARG_STR };
+    Type type;
+    union {
+        long long i;
+        unsigned long long u;
+        double d;
+        const void* p;
+    };
+};
+
+static const int LOG_MAX_ARGS = 8;
+
+struct LogRecord {
+    long long time_ms;   // Wall clock at the producer (formatted by the flusher)
+    int level;
+    int category;
+    const char* fmt;     // String literal (deferred record) or nullptr (text holds the line)
+    int argc;
+    LogArg args[LOG_MAX_ARGS];
+    char text[160];      // Preformatted line, or copies of ARG_STR arguments
+};
+
+class Logger {
+public:
+    static Logger& Instance() {
+        static Logger instance;
+        return instance;
+    }
+
+    // Runtime check (level and category mask from [LOGGING])
+    bool Enabled(int level, int category = LOGCAT_GENERAL) const {
+        return level <= m_level.load(std::memory_order_relaxed) &&
+               (category & m_categories.load(std::memory_order_relaxed)) != 0;
+    }
+
+    void SetLevel(int level) { m_level.store(level, std::memory_order_relaxed); }
+    void SetCategories(int mask) { m_categories.store(mask, std::memory_order_relaxed); }
+    void SetMaxBytes(long bytes) { m_max_bytes.store(bytes > 4096 ? bytes : 4096, std::memory_order_relaxed); }
+
+    // [LOGGING] Level=ERROR|WARN|INFO|DEBUG|TRACE (or 0-4)
+    static int ParseLevel(const std::string& v, int fallback) {
+        if (v == "ERROR") return LOG_ERROR;
+        if (v == "WARN") return LOG_WARN;
+        if (v == "INFO") return LOG_INFO;
+        if (v == "DEBUG") return LOG_DEBUG;
+        if (v == "TRACE") return LOG_TRACE;
+        if (v.size() == 1 && v[0] >= '0' && v[0] <= '4') return v[0] - '0';
+        return fallback;
+    }
+
+    // [LOGGING] Categories=HID,DISPATCH,DISPLAY,CONFIG,GENERAL (or ALL)
+    static int ParseCategories(const std::string& v) {
+        static const struct { const char* name; int bit; } kNames[] = {
+            { "HID", LOGCAT_HID }, { "DISPATCH", LOGCAT_DISPATCH }, { "DISPLAY", LOGCAT_DISPLAY },
+            { "CONFIG", LOGCAT_CONFIG }, { "GENERAL", LOGCAT_GENERAL }, { "ALL", LOGCAT_ALL } };
+        int mask = 0;
+        for (const auto& n : kNames) {
+            if (v.find(n.name) != std::string::npos) mask |= n.bit;
+        }
+        return mask;
+    }
+
+    // Already formatted line (cold paths)
+    void Write(int level, const char* text, int category = LOGCAT_GENERAL) {
+        if (!Enabled(level, category) || !text) return;
+        size_t pos;
+        Cell* cell = Reserve(pos);
+        if (!cell) return;
+        cell->rec.fmt = nullptr;
+        cell->rec.argc = 0;
+        strncpy(cell->rec.text, text, sizeof(cell->rec.text) - 1);
+        cell->rec.text[sizeof(cell->rec.text) - 1] = 0;
+        Commit(cell, pos, level, category);
+    }
+
+    // Deferred formatting: stores the format literal and the raw arguments.
+    // Use through SF_LOG so disabled levels/categories are compiled out.
+    template <typename... Args>
+    void Log(int level, int category, const char* fmt, const Args&... args) {
+        static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "SF_LOG: too many arguments");
+        if (!Enabled(level, category)) return;
+        size_t pos;
+        Cell* cell = Reserve(pos);
+        if (!cell) return;
+        LogRecord& r = cell->rec;
+        r.fmt = fmt;
+        r.argc = 0;
+        size_t used = 0;
+        int expand[] = { 0, (PackArg(r, used, args), 0)... };
+        (void)expand; (void)used;
+        Commit(cell, pos, level, category);
+    }
+
+    // Flush and stop the background thread (DLL unload; never from a static destructor)
+    void Shutdown() {
+        std::lock_guard<std::mutex> lock(m_start_mutex);
+        if (!m_thread.joinable()) return;
+        m_running = false;
+        m_thread.join();
+    }
+
+private:
+    static const size_t RING_SIZE = 512; // Power of two
+    static const size_t RING_MASK = RING_SIZE - 1;
+
+    struct Cell {
+        std::atomic<size_t> seq;
+        LogRecord rec;
+    };
+
+    Cell m_cells[RING_SIZE];
+    std::atomic<size_t> m_enqueue_pos;
+    size_t m_dequeue_pos;                // Flusher thread only
+    std::atomic<int> m_level;
+    std::atomic<int> m_categories;
+    std::atomic<long> m_max_bytes;
+    std::atomic<unsigned int> m_dropped;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_started;
+    std::mutex m_start_mutex;
+    std::thread m_thread;
+
+    // Flusher state
+    FILE* m_file;
+    long m_file_size;
+    std::string m_path, m_rotated_path;
+
+    Logger() : m_enqueue_pos(0), m_dequeue_pos(0), m_level(LOG_INFO), m_categories(LOGCAT_ALL), m_max_bytes(1024 * 1024),
+               m_dropped(0), m_running(false), m_started(false), m_file(nullptr), m_file_size(0) {
+        for (size_t i = 0; i < RING_SIZE; i++) m_cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    ~Logger() {
+        // Joining here could deadlock under the loader lock: Shutdown() is the clean path
+        if (m_thread.joinable()) m_thread.detach();
+    }
+
+    void EnsureStarted() {
+        if (m_started.load(std::memory_order_acquire)) return;
+        std::lock_guard<std::mutex> lock(m_start_mutex);
+        if (m_started.load(std::memory_order_relaxed)) return;
+        const char* appData = getenv("APPDATA");
+        if (appData) {
+            m_path = std::string(appData) + "\\REAPER\\UserPlugins\\SoundFirst_Logs.txt";
+            m_rotated_path = std::string(appData) + "\\REAPER\\UserPlugins\\SoundFirst_Logs.1.txt";
+        }
+        m_running = true;
+        m_thread = std::thread(&Logger::FlusherLoop, this);
+        m_started.store(true, std::memory_order_release);
+    }
+
+    // Reserve a cell (Vyukov bounded MPMC ring, single consumer here)
+    Cell* Reserve(size_t& pos) {
+        EnsureStarted();
+        pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell* cell = &m_cells[pos & RING_MASK];
+            size_t seq = cell->seq.load(std::memory_order_acquire);
+            intptr_t dif = (intptr_t)seq - (intptr_t)pos;
+            if (dif == 0) {
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) return cell;
+            } else if (dif < 0) {
+                m_dropped.fetch_add(1, std::memory_order_relaxed); // Ring full: never block the caller
+                return nullptr;
+            } else {
+                pos = m_enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void Commit(Cell* cell, size_t pos, int level, int category) {
+        cell->rec.time_ms = (long long)std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        cell->rec.level = level;
+        cell->rec.category = category;
+        cell->seq.store(pos + 1, std::memory_order_release);
+    }
+
+    // --- Argument capture (producer side, no formatting) ---
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value>::type
+    PackArg(LogRecord& r, size_t&, T v) {
+        LogArg& a = r.args[r.argc++];
+        if (std::is_signed<T>::value) { a.type = LogArg::ARG_INT; a.i = (long long)v; }
+        else { a.type = LogArg::ARG_UINT; a.u = (unsigned long long)v; }
+    }
+    static void PackArg(LogRecord& r, size_t&, double v) {
+        LogArg& a = r.args[r.argc++];
+        a.type = LogArg::ARG_DOUBLE; a.d = v;
+    }
+    static void PackArg(LogRecord& r, size_t&, const void* p) {
+        LogArg& a = r.args[r.argc++];
+        a.type = LogArg::ARG_PTR; a.p = p;
+    }
+    // Strings are copied: the caller's buffer may be gone before the flush
+    static void PackArg(LogRecord& r, size_t& used, const char* s) {
+        LogArg& a = r.args[r.argc++];
+        a.type = LogArg::ARG_STR; a.i = (long long)used;
+        size_t room = sizeof(r.text) - used;
+        size_t n = 0;
+        if (s) { while (s[n] && n + 1 < room) { r.text[used + n] = s[n]; n++; } }
+        r.text[used + n] = 0;
+        used += (n + 1 < room) ? n + 1 : room - 1;
+    }
+    static void PackArg(LogRecord& r, size_t& used, const std::string& s) { PackArg(r, used, s.c_str()); }
+
+    // --- Deferred printf (flusher side) ---
+    // Length modifiers in the literal are ignored: integers are always 64-bit here.
+    static void FormatDeferred(const LogRecord& r, char* out, size_t cap) {
+        size_t n = 0;
+        int next = 0;
+        const char* f = r.fmt;
+        while (*f && n + 1 < cap) {
+            if (*f != '%') { out[n++] = *f++; continue; }
+            if (f[1] == '%') { out[n++] = '%'; f += 2; continue; }
+
+            char spec[32]; size_t s = 0;
+            spec[s++] = *f++;
+            while (*f && strchr("-+ #0123456789.", *f) && s < 20) spec[s++] = *f++;
+            while (*f && strchr("hlLzjt", *f)) f++;
+            char conv = *f;
+            if (!conv || next >= r.argc) break;
+            f++;
+
+            const LogArg& a = r.args[next++];
+            size_t room = cap - n;
+            int w = 0;
+            switch (conv) {
+                case 'd': case 'i': case 'u': case 'x': case 'X': case 'o': {
+                    long long iv = (a.type == LogArg::ARG_DOUBLE) ? (long long)a.d : a.i;
+                    spec[s++] = 'l'; spec[s++] = 'l'; spec[s++] = conv; spec[s] = 0;
+                    w = snprintf(out + n, room, spec, iv);
+                    break;
+                }
+                case 'c':
+                    spec[s++] = 'c'; spec[s] = 0;
+                    w = snprintf(out + n, room, spec, (int)a.i);
+                    break;
+                case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': {
+                    double dv = (a.type == LogArg::ARG_DOUBLE) ? a.d
+                              : (a.type == LogArg::ARG_UINT) ? (double)a.u : (double)a.i;
+                    spec[s++] = conv; spec[s] = 0;
+                    w = snprintf(out + n, room, spec, dv);
+                    break;
+                }
+                case 's':
+                    spec[s++] = 's'; spec[s] = 0;
+                    w = snprintf(out + n, room, spec, (a.type == LogArg::ARG_STR) ? r.text + a.i : "(?)");
+                    break;
+                case 'p':
+                    spec[s++] = 'p'; spec[s] = 0;
+                    w = snprintf(out + n, room, spec, a.p);
+                    break;
+                default:
+                    break;
+            }
+            if (w > 0) n += ((size_t)w < room) ? (size_t)w : room - 1;
+        }
+        out[n] = 0;
+    }
+
+    bool TryPop(LogRecord& out) {
+        Cell& cell = m_cells[m_dequeue_pos & RING_MASK];
+        size_t seq = cell.seq.load(std::memory_order_acquire);
+        if ((intptr_t)seq - (intptr_t)(m_dequeue_pos + 1) < 0) return false; // Empty
+        out = cell.rec;
+        cell.seq.store(m_dequeue_pos + RING_SIZE, std::memory_order_release);
+        m_dequeue_pos++;
+        return true;
+    }
+
+    void OpenFile() {
+        if (m_file || m_path.empty()) return;
+        m_file = fopen(m_path.c_str(), "ab");
+        if (!m_file) return;
+        fseek(m_file, 0, SEEK_END);
+        m_file_size = ftell(m_file);
+    }
+
+    void RotateIfNeeded() {
+        if (!m_file || m_file_size < m_max_bytes.load(std::memory_order_relaxed)) return;
+        fclose(m_file); m_file = nullptr;
+        remove(m_rotated_path.c_str());
+        rename(m_path.c_str(), m_rotated_path.c_str());
+        OpenFile();
+    }
+
+    // Drains everything queued into one buffer, one fwrite per batch
+    void Drain() {
+        static const char* kLevelTag[] = { "ERROR", "WARN", "INFO", "DEBUG", "TRACE" };
+        char msg[256];
+        char batch[16384];
+        size_t used = 0;
+        LogRecord rec;
+
+        unsigned int dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped) used += snprintf(batch, sizeof(batch), "[LOG] %u records dropped (ring full)\n", dropped);
+
+        while (TryPop(rec)) {
+            time_t secs = (time_t)(rec.time_ms / 1000);
+            struct tm lt;
+#ifdef _WIN32
+            localtime_s(&lt, &secs);
+#else
+            localtime_r(&secs, &lt);
+#endif
+            int lvl = (rec.level >= LOG_ERROR && rec.level <= LOG_TRACE) ? rec.level : LOG_INFO;
+            const char* text = rec.text;
+            if (rec.fmt) { FormatDeferred(rec, msg, sizeof(msg)); text = msg; }
+            char line[320];
+            int n = snprintf(line, sizeof(line), "[%02d:%02d:%02d.%03d] %-5s %s%s\n",
+                             lt.tm_hour, lt.tm_min, lt.tm_sec, (int)(rec.time_ms % 1000), kLevelTag[lvl],
+                             CategoryTag(rec.category), text);
+            if (n < 0) continue;
+            if ((size_t)n >= sizeof(line)) n = sizeof(line) - 1;
+            if (used + n > sizeof(batch)) { WriteBatch(batch, used); used = 0; } // Batch full
+            memcpy(batch + used, line, n);
+            used += n;
+        }
+        WriteBatch(batch, used);
+    }
+
+    static const char* CategoryTag(int category) {
+        switch (category) {
+            case LOGCAT_HID: return "[HID] ";
+            case LOGCAT_DISPATCH: return "[DISPATCH] ";
+            case LOGCAT_DISPLAY: return "[DISPLAY] ";
+            case LOGCAT_CONFIG: return "[CONFIG] ";
+            default: return "";
+        }
+    }
+
+    void WriteBatch(const char* data, size_t len) {
+        if (!len) return;
+        OpenFile();
+        if (!m_file) return;
+        fwrite(data, 1, len, m_file);
+        fflush(m_file);
+        m_file_size += (long)len;
+        RotateIfNeeded();
+    }
+
+    void FlusherLoop() {
+        while (m_running) {
+            Drain();
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        Drain(); // Final flush on Shutdown()
+        if (m_file) { fclose(m_file); m_file = nullptr; }
+    }
+};
+
+// Front-end: SF_LOG(LOG_DEBUG, LOGCAT_HID, "Byte 3: %02X", data[3]);
+// The compile-time test comes first, so disabled statements are dead code and
+// their arguments are never evaluated. Enabled ones only capture raw values.
+#define SF_LOG_ON(level, category) \
+    (LogCompiled<(level), (category)>::value && Logger::Instance().Enabled((level), (category)))
+
+#define SF_LOG(level, category, ...) \
+    do { if (SF_LOG_ON(level, category)) Logger::Instance().Log((level), (category), __VA_ARGS__); } while (0)
@@ -1,26 +1,27 @@
 // Windows and Standard includes
+#ifdef _WIN32
 #include <windows.h>
+#endif
 #include <stdio.h>
 
 // IMPLEMENT REAPER API HERE - must be before including csurf header
 #define REAPERAPI_IMPLEMENT
 
 #include "csurf_soundfirst.h"
+#include "logger.h"
 
-// Global surface pointer (reaKontrol pattern)
-IReaperControlSurface* g_surface = nullptr;
+// One surface per connected keyboard (reaKontrol pattern, N instances)
+std::vector<CSurf_SoundFirst*> g_surfaces;
+DeviceRegistry g_devices;
+ConfigWatcher g_config;   // SoundFirst_PRO.ini: one watcher thread, one parse per save, for all surfaces
 reaper_plugin_info_t* g_rec = nullptr; 
 void* (*g_GetFunc)(const char* name) = nullptr; // Global pointer (1-arg version)
 
 extern "C" {
 
+// Queued on the async logger; the flusher thread does the file I/O
 void RawLog(const char* txt) {
-    char* appData = getenv("APPDATA");
-    if (appData) {
-        char path[512]; sprintf(path, "%s\\REAPER\\UserPlugins\\SoundFirst_Logs.txt", appData);
-        FILE* f = fopen(path, "a");
-        if (f) { fprintf(f, "[ENTRY] %s\n", txt); fclose(f); }
-    }
+    Logger::Instance().Write(LOG_INFO, txt);
 }
 
 REAPER_PLUGIN_DLL_EXPORT int REAPER_PLUGIN_ENTRYPOINT(
@@ -43,19 +44,32 @@ REAPER_PLUGIN_DLL_EXPORT int REAPER_PLUGIN_ENTRYPOINT(
             return 0;
         }
 
-        // Create surface directly (reaKontrol pattern - NOT a factory)
-        g_surface = new CSurf_SoundFirst(0, 0, 0); // Default ports for now
-        
-        // Register the surface instance directly
-        rec->Register("csurf_inst", (void*)g_surface);
+        // Create surfaces directly (reaKontrol pattern - NOT a factory): one per keyboard
+        // connected now, or a single one that takes the first keyboard plugged in later
+        std::vector<SurfaceDevice> found;
+        ScanSurfaceDevices(found);
+        g_devices.Update(found);
+        std::vector<SurfaceDevice> devices = g_devices.Devices();
+        if (devices.empty()) devices.push_back(SurfaceDevice());
+
+        // Hot-reload: the watcher thread parses changed INI files; each surface adopts the snapshot on its next tick
+        std::string ini = CSurf_SoundFirst::ConfigPath();
+        g_config.Start(ini, &CSurf_SoundFirst::ParseConfig, CSurf_SoundFirst::ParseConfig(ini));
+
+        for (const SurfaceDevice& dev : devices) {
+            CSurf_SoundFirst* surface = new CSurf_SoundFirst(0, 0, 0, &g_devices, dev, &g_config); // Default ports for now
+            g_surfaces.push_back(surface);
+            // Register the surface instance directly
+            rec->Register("csurf_inst", (void*)surface);
+        }
         
         return 1;
     } else {
         // UNLOAD
-        if (g_surface) {
-            delete g_surface;
-            g_surface = nullptr;
-        }
+        for (CSurf_SoundFirst* surface : g_surfaces) delete surface;
+        g_surfaces.clear();
+        g_config.Stop();
+        Logger::Instance().Shutdown(); // Flush pending lines before the DLL goes away
         return 0;
     }
 }
@@ -0,0 +1,102 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// --- METER ENGINE ---
+// The keyboard meter (0x49) is fed at a fixed rate with locally shaped values,
+// independent of how often REAPER calls Run(). Sending is change-only (see
+// DisplayModel), so steady or silent signals produce no USB traffic.
+
+// Amplitude (Track_GetPeakInfo) to dB. Same floor as MKVOL2DB.
+inline double MeterAmpToDb(double amp) {
+    return (amp <= 0.0000000298023223876953125) ? -150.0 : (20.0 * log10(amp));
+}
+
+// dB to the 0..127 LCD scale. Default maps -60 dB (0) to +6 dB (127).
+inline int QuantizeMeterDb(double db, double lo_db = -60.0, double hi_db = 6.0) {
+    if (db <= lo_db) return 0;
+    int v = (int)((db - lo_db) * (127.0 / (hi_db - lo_db)));
+    return (v > 127) ? 127 : v;
+}
+
+// Fast log2: exponent bits + quadratic on the mantissa. Max error ~0.06 dB once
+// scaled to dB, well under one LCD step (66 dB / 127 = 0.52 dB).
+inline float MeterFastLog2(float x) {
+    uint32_t bits; memcpy(&bits, &x, sizeof(bits));
+    float e = (float)((int)((bits >> 23) & 0xFF) - 127);
+    bits = (bits & 0x007FFFFF) | 0x3F800000; // Mantissa in [1, 2)
+    float m; memcpy(&m, &bits, sizeof(m));
+    return e + (-0.34484843f * m + 2.02466578f) * m - 1.67981735f;
+}
+
+// Bank conversion: max(L, R) -> dB for n slots in one branch-free pass so the
+// compiler can vectorize it. Silence is clamped to -150 dB like MeterAmpToDb.
+inline void MeterBankToDb(const float* peak_l, const float* peak_r, float* out_db, int n) {
+    const float kDbPerOctave = 6.0205999f;          // 20 * log10(2)
+    const float kFloor = 0.0000000298023223876953125f;
+    for (int i = 0; i < n; i++) {
+        float p = (peak_l[i] > peak_r[i]) ? peak_l[i] : peak_r[i];
+        p = (p > kFloor) ? p : kFloor;
+        out_db[i] = kDbPerOctave * MeterFastLog2(p);
+    }
+}
+
+// Attack / peak-hold / release, all in dB
+struct MeterBallistics {
+    double attack_ms = 5.0;            // Rise time constant
+    double hold_ms = 500.0;            // Peak hold before the bar starts falling
+    double release_db_per_sec = 24.0;  // Fall rate after hold
+
+    double level_db = -150.0;
+    double hold_until = 0.0;
+    double last_time = 0.0;
+
+    void Reset() { level_db = -150.0; hold_until = 0.0; last_time = 0.0; }
+
+    double Process(double in_db, double now) {
+        double dt = (last_time > 0.0) ? (now - last_time) : 0.0;
+        last_time = now;
+        if (in_db >= level_db) {
+            // Attack: exponential approach (instant when attack_ms == 0)
+            if (attack_ms <= 0.0 || dt <= 0.0) level_db = in_db;
+            else level_db += (in_db - level_db) * (1.0 - exp(-(dt * 1000.0) / attack_ms));
+            hold_until = now + (hold_ms / 1000.0);
+        } else if (now >= hold_until) {
+            // Release: linear dB fall, never below the input
+            level_db -= release_db_per_sec * dt;
+            if (level_db < in_db) level_db = in_db;
+        }
+        return level_db;
+    }
+};
+
+// Fixed-rate sampling clock for one or more meters
+struct MeterClock {
+    double rate_hz = 30.0;
+    double next_time = 0.0;
+
+    bool Due(double now) {
+        if (now < next_time) return false;
+        double period = 1.0 / ((rate_hz > 1.0) ? rate_hz : 1.0);
+        next_time += period;
+        if (next_time <= now) next_time = now + period; // Resync after stalls
+        return true;
+    }
+};
+
+// Which FX on the metered track can report gain reduction. Probed once per FX
+// and kept until the chain, selection or track list changes.
+struct GrSourceCache {
+    enum Source { GR_UNKNOWN = 0, GR_NATIVE, GR_MAPPED, GR_NONE };
+    struct Entry {
+        Source source = GR_UNKNOWN;
+        int meter_param = -1;       // GR_MAPPED only
+        double range_db = 20.0;
+    };
+    void* track = nullptr;          // MediaTrack* the entries belong to
+    std::vector<Entry> fx;
+
+    void Invalidate() { track = nullptr; fx.clear(); }
+};
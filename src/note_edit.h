@@ -0,0 +1,49 @@
+#pragma once
+#include <cmath>
+#include <cstdlib>
+
+// --- MIDI NOTE EDIT BATCH ---
+// MIDI editor open: K3-K6 move, resize, transpose and re-velocity the selected notes.
+struct NoteEditBatch {
+    enum Kind { NOTE_MOVE = 0, NOTE_LENGTH, NOTE_PITCH, NOTE_VELOCITY, NUM_KINDS };
+    enum { FINE_PER_GRID = 16 };   // Shift moves / resizes in 1/16 grid steps
+
+    int counts_per_step = 3;       // Knob counts per edit step ([MIDI] NoteStepCounts)
+    int remainder[NUM_KINDS] = {}; // Counts below one step, carried between drains
+    int amount[NUM_KINDS] = {};    // Move / length: 1/16 grid; pitch: semitones; velocity: units
+
+    // Shift = fine move / resize, octave transpose, velocity +-10
+    void Add(int kind, int d, bool shift) {
+        if (d == 0) return;
+        int& r = remainder[kind];
+        if ((r > 0 && d < 0) || (r < 0 && d > 0)) r = 0;  // Reversing answers at once
+        r += d;
+        int steps = r / counts_per_step;
+        if (steps == 0) return;
+        r -= steps * counts_per_step;
+        static const int kUnit[NUM_KINDS][2] = { { FINE_PER_GRID, 1 }, { FINE_PER_GRID, 1 }, { 1, 12 }, { 1, 10 } };
+        amount[kind] += steps * kUnit[kind][shift ? 1 : 0];
+    }
+
+    bool Pending() const {
+        return amount[NOTE_MOVE] || amount[NOTE_LENGTH] || amount[NOTE_PITCH] || amount[NOTE_VELOCITY];
+    }
+
+    // Applied: the next drain starts from zero (remainders stay)
+    void Clear() { for (int i = 0; i < NUM_KINDS; i++) amount[i] = 0; }
+
+    // One note, in PPQ. grid_ppq = length of one grid step in the take.
+    void ApplyTo(double grid_ppq, double& start, double& end, int& pitch, int& vel) const {
+        double fine = grid_ppq / FINE_PER_GRID;
+        double min_len = (fine >= 1.0) ? fine : 1.0;
+        double move = std::floor(amount[NOTE_MOVE] * fine + 0.5);
+        double len = std::floor(amount[NOTE_LENGTH] * fine + 0.5);
+        start += move;
+        end += move + len;
+        if (end - start < min_len) end = start + min_len;
+        pitch += amount[NOTE_PITCH];
+        if (pitch < 0) pitch = 0; else if (pitch > 127) pitch = 127;
+        vel += amount[NOTE_VELOCITY];
+        if (vel < 1) vel = 1; else if (vel > 127) vel = 127;
+    }
+};
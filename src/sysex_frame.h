@@ -0,0 +1,59 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstring>
+
+// NHL (Native Host Link) SysEx framing, allocation free.
+// Layout: F0 00 21 09 00 00 44 43 01 00 | CMD | VALUE | INDEX | [TEXT...] | F7
+// Requires reaper_plugin.h (MIDI_event_t) to be included first.
+
+static const std::array<unsigned char, 10> NHL_SYSEX_HEADER = { 0xF0, 0x00, 0x21, 0x09, 0x00, 0x00, 0x44, 0x43, 0x01, 0x00 };
+static const size_t NHL_FRAME_FIXED = 10 + 3 + 1; // Header + Cmd/Val/Idx + F7
+
+// A MIDI_event_t with inline storage for one NHL frame of up to MAX_TEXT characters.
+// The header is written once at construction; each Build*() only rewrites the
+// command, value, index and text bytes, so the buffer is reused for every frame.
+template <size_t MAX_TEXT>
+class NhlSysexFrame {
+public:
+    static const size_t CAPACITY = NHL_FRAME_FIXED + MAX_TEXT;
+
+    NhlSysexFrame() {
+        Event()->frame_offset = 0;
+        Event()->size = 0;
+        memcpy(Message(), NHL_SYSEX_HEADER.data(), NHL_SYSEX_HEADER.size());
+    }
+
+    // Value frame (meter, track state): fixed 14 bytes
+    MIDI_event_t* BuildValue(unsigned char cmd, int val, unsigned char idx) {
+        unsigned char* m = Message();
+        m[10] = cmd;
+        m[11] = (unsigned char)(val & 0x7F); // Clamp 0-127
+        m[12] = idx & 0x7F;
+        m[13] = 0xF7;
+        Event()->size = (int)NHL_FRAME_FIXED;
+        return Event();
+    }
+
+    // Text frame: non printable / non ASCII characters are dropped
+    MIDI_event_t* BuildText(unsigned char cmd, unsigned char idx, const char* text) {
+        unsigned char* m = Message();
+        m[10] = cmd;
+        m[11] = 0; // Value
+        m[12] = idx & 0x7F;
+        size_t n = 13;
+        for (size_t i = 0; text[i] != 0 && i < MAX_TEXT; i++) {
+            if (text[i] >= 32 && text[i] < 127) m[n++] = (unsigned char)text[i];
+        }
+        m[n++] = 0xF7;
+        Event()->size = (int)n;
+        return Event();
+    }
+
+private:
+    MIDI_event_t* Event() { return reinterpret_cast<MIDI_event_t*>(m_storage.data()); }
+    unsigned char* Message() { return Event()->midi_message; }
+
+    // midi_message[4] is declared inside MIDI_event_t; the rest trails it
+    alignas(MIDI_event_t) std::array<unsigned char, sizeof(MIDI_event_t) + CAPACITY> m_storage;
+};
@@ -0,0 +1,86 @@
+#pragma once
+
+// --- RUN() TIME BUDGET ---
+// Run() is called on REAPER's UI thread (~30 Hz). Input is always applied;
+// the phases after it (display, meter, speech) only run while the tick is
+// under budget, and are otherwise deferred to a later tick. A deferred phase
+// runs anyway once it has waited max_defer ticks, so nothing starves.
+// Times come from the caller (time_precise), so this has no REAPER dependency.
+struct TickBudget {
+    enum Phase {
+        PHASE_CONFIG = 0,  // Hot-reload snapshot swap
+        PHASE_HOST,        // Dirty flags from host notifications
+        PHASE_INPUT,       // HID frames, gesture / value timeouts (never deferred)
+        PHASE_DISPLAY,
+        PHASE_METER,
+        PHASE_SPEECH,
+        NUM_PHASES
+    };
+
+    struct PhaseStats {
+        int max_defer = 0;          // Ticks it may be skipped in a row (0 = never deferred)
+        int waiting = 0;            // Consecutive ticks skipped so far
+        unsigned int runs = 0;
+        unsigned int deferred = 0;
+        double total = 0.0;         // Seconds spent, for the average
+        double worst = 0.0;
+    };
+
+    double budget = 0.001;          // Seconds per tick ([PERFORMANCE] TickBudgetMs)
+    PhaseStats phases[NUM_PHASES];
+    unsigned int ticks = 0;
+    unsigned int over_budget = 0;   // Ticks that ended past the budget
+    double worst_tick = 0.0;
+
+    double tick_start = 0.0;
+    double phase_start = 0.0;
+
+    TickBudget() {
+        phases[PHASE_DISPLAY].max_defer = 3;  // ~100 ms at 30 Hz
+        phases[PHASE_METER].max_defer = 3;
+        phases[PHASE_SPEECH].max_defer = 2;   // Speech latency is felt first
+    }
+
+    void BeginTick(double now) { tick_start = now; ticks++; }
+
+    // true: run the phase now (call EndPhase after it). false: deferred this tick.
+    bool BeginPhase(int phase, double now) {
+        PhaseStats& p = phases[phase];
+        if (p.max_defer > 0 && now - tick_start >= budget && p.waiting < p.max_defer) {
+            p.waiting++;
+            p.deferred++;
+            return false;
+        }
+        p.waiting = 0;
+        phase_start = now;
+        return true;
+    }
+
+    void EndPhase(int phase, double now) {
+        PhaseStats& p = phases[phase];
+        double dt = now - phase_start;
+        p.runs++;
+        p.total += dt;
+        if (dt > p.worst) p.worst = dt;
+    }
+
+    void EndTick(double now) {
+        double dt = now - tick_start;
+        if (dt > budget) over_budget++;
+        if (dt > worst_tick) worst_tick = dt;
+    }
+
+    // Clears the counters (after they were reported), keeps the settings
+    void ResetStats() {
+        ticks = 0; over_budget = 0; worst_tick = 0.0;
+        for (int i = 0; i < NUM_PHASES; i++) {
+            phases[i].runs = 0; phases[i].deferred = 0;
+            phases[i].total = 0.0; phases[i].worst = 0.0;
+        }
+    }
+
+    static const char* PhaseName(int phase) {
+        static const char* kNames[NUM_PHASES] = { "config", "host", "input", "display", "meter", "speech" };
+        return (phase >= 0 && phase < NUM_PHASES) ? kNames[phase] : "?";
+    }
+};
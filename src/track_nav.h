@@ -0,0 +1,51 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+
+class MediaTrack;
+
+// --- TRACK NAVIGATION ---
+// Encoder up / down on a cached track array; fast repeats jump 2, 4, then 8 tracks (Shift: a bank).
+struct TrackNav {
+    enum { BANK_SIZE = 8 };
+
+    double repeat_ms = 150.0;          // Pushes closer than this build a streak ([ENCODER] TrackRepeatMs)
+    int max_jump = BANK_SIZE;          // Largest streak jump ([ENCODER] TrackMaxJump)
+
+    std::vector<MediaTrack*> tracks;   // GetTrack(NULL, i) for every track
+    bool tracks_valid = false;         // False after a track list change
+    int current = -1;                  // Index of the selected track in tracks, -1 = unknown
+
+    int pending = 0;                   // Tracks to move in this drain
+    int streak = 0;
+    int last_dir = 0;
+    double last_time = -1.0;
+
+    void Invalidate() { tracks_valid = false; current = -1; }
+
+    void Add(int dir, bool shift, double now) {
+        bool repeat = dir == last_dir && last_time >= 0.0 && now - last_time < repeat_ms / 1000.0;
+        streak = repeat ? streak + 1 : 0;
+        last_dir = dir;
+        last_time = now;
+        pending += dir * (shift ? BANK_SIZE : Jump());
+    }
+
+    // Every 3 repeats double the jump: 1, 2, 4, 8 (capped at max_jump)
+    int Jump() const {
+        int j = 1 << std::min(streak / 3, 3);
+        return (j > max_jump) ? std::max(max_jump, 1) : j;
+    }
+
+    int IndexOf(MediaTrack* t) const {
+        auto it = std::find(tracks.begin(), tracks.end(), t);
+        return (it == tracks.end()) ? -1 : (int)(it - tracks.begin());
+    }
+
+    // No track selected: down starts at the first track, up at the last. Clamped at both ends.
+    int Target(int steps) const {
+        int n = (int)tracks.size();
+        int from = (current >= 0) ? current : (steps > 0 ? -1 : n);
+        return std::max(0, std::min(n - 1, from + steps));
+    }
+};
@@ -43,6 +43,7 @@ class FXMapping:
         self.pages = [Page()]
         self.buttons = {k: -1 for k in MAPPABLE_BUTTONS}
         self.params = {} # pid -> name
+        self.main_extra = {} # Other [Main] keys (e.g. MeterParam) preserved on save
 
 # --- WIZARD PANELS ---
 
@@ -590,6 +591,7 @@ class MainFrame(wx.Frame):
             
         self.mapping = FXMapping()
         self.mapping.plugin_name = config['Main'].get('PluginName', "Unknown")
+        self.mapping.main_extra = {k: v for k, v in config['Main'].items() if k.lower() != 'pluginname'}
         
         # Load Pages
         self.mapping.pages = []
@@ -659,6 +661,8 @@ class MainFrame(wx.Frame):
         config = configparser.ConfigParser()
         
         config['Main'] = {'PluginName': self.mapping.plugin_name}
+        for k, v in self.mapping.main_extra.items():
+            config['Main'][k] = v
         
         for i, page in enumerate(self.mapping.pages):
             sec = f"Page{i+1}"